@@ -0,0 +1,604 @@
+#include "collections/meta.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <ctime>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <latch>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <regex>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+// Micro-benchmarks for GC::Ptr, ptr::VSharedPtr and std::shared_ptr.
+//
+// Results go to stdout as JSON in the Google Benchmark format, so that runs
+// of two releases can be compared with its tools/compare.py; progress goes
+// to stderr.  Flags, all optional:
+//
+//   --benchmark_filter=<regex>     run the benchmarks whose name matches
+//   --benchmark_min_time=<secs>    measure each for at least this long (0.5)
+//   --benchmark_out=<file>         write the JSON there instead
+//   --threads=<n>                  largest thread count (hardware threads)
+
+namespace {
+
+    using bench_clock = std::chrono::steady_clock;
+
+    // ── Harness ───────────────────────────────────────────────────────────────
+
+    /// Keeps @p p, and the object behind it, from being optimized away.
+    template <typename T>
+    void escape(T* p) noexcept
+    {
+#if defined(__GNUC__) || defined(__clang__)
+        asm volatile("" : : "g"(p) : "memory");
+#else
+        static thread_local const void* volatile sink;
+        sink = p;
+#endif
+    }
+
+    /// One run of a benchmark: the body times its own measured part.
+    class run_state {
+    public:
+        run_state(std::uint64_t iterations, unsigned threads) : iterations(iterations), threads(threads) {}
+
+        const std::uint64_t iterations;   ///< per thread
+        const unsigned      threads;
+
+        void start() noexcept
+        {
+            cpu_start_ = std::clock();
+            start_ = bench_clock::now();
+        }
+
+        void stop() noexcept
+        {
+            elapsed_ += bench_clock::now() - start_;
+            cpu_ += static_cast<double>(std::clock() - cpu_start_) / CLOCKS_PER_SEC;
+        }
+
+        /// Items processed in total; iterations × threads unless set.
+        void set_items(std::uint64_t items) noexcept { items_ = items; }
+        void set_counter(std::string name, double value) { counters_.emplace_back(std::move(name), value); }
+
+        [[nodiscard]] std::chrono::duration<double> elapsed() const noexcept { return elapsed_; }
+        [[nodiscard]] double cpu_seconds() const noexcept { return cpu_; }
+        [[nodiscard]] std::uint64_t items() const noexcept { return items_ ? *items_ : iterations * threads; }
+        [[nodiscard]] const auto& counters() const noexcept { return counters_; }
+
+    private:
+        bench_clock::time_point                      start_{};
+        std::clock_t                                 cpu_start_{};
+        std::chrono::duration<double>                elapsed_{ 0 };
+        double                                       cpu_{ 0 };
+        std::optional<std::uint64_t>                 items_;
+        std::vector<std::pair<std::string, double>>  counters_;
+    };
+
+    /**
+     * Run @p work(thread, iterations) on s.threads threads, timing from the
+     * moment they are all released until the last one is joined.  @p work
+     * returns what it computed, so that the traversals are not dead code.
+     */
+    template <typename F>
+    void run_threads(run_state& s, F&& work)
+    {
+        std::latch ready{ static_cast<std::ptrdiff_t>(s.threads) + 1 };
+        std::atomic<std::int64_t> checksum{ 0 };
+        std::vector<std::thread> workers;
+        workers.reserve(s.threads);
+        for (unsigned t = 0; t != s.threads; ++t) {
+            workers.emplace_back([&, t] {
+                ready.arrive_and_wait();
+                checksum.fetch_add(work(t, s.iterations), std::memory_order_relaxed);
+            });
+        }
+        ready.arrive_and_wait();
+        s.start();
+        for (std::thread& w : workers)
+            w.join();
+        s.stop();
+        escape(&checksum);
+    }
+
+    struct benchmark {
+        std::string                     name;
+        unsigned                        threads;
+        std::function<void(run_state&)> body;
+    };
+
+    struct options {
+        std::chrono::duration<double> min_time{ 0.5 };
+        std::optional<std::regex>     filter;
+        std::string                   out;            ///< empty: stdout
+        unsigned                      max_threads{ std::max(std::thread::hardware_concurrency(), 1u) };
+    };
+
+    struct result {
+        std::string                                  name;
+        unsigned                                     threads;
+        std::uint64_t                                iterations;
+        double                                       real_ns;     ///< per iteration
+        double                                       cpu_ns;
+        double                                       items_per_second;
+        std::vector<std::pair<std::string, double>>  counters;
+    };
+
+    /// Grow the iteration count until one run lasts at least the minimum time.
+    result measure(const benchmark& b, const options& opt)
+    {
+        constexpr std::uint64_t max_iterations = 1'000'000'000;
+        std::uint64_t n = 1;
+        while (true) {
+            run_state s{ n, b.threads };
+            b.body(s);
+            GC::gc_collect();   // leave no garbage to the next run
+
+            const double secs = s.elapsed().count();
+            if (secs >= opt.min_time.count() || n >= max_iterations) {
+                const double iterations = static_cast<double>(n);
+                return { b.name, b.threads, n, secs * 1e9 / iterations, s.cpu_seconds() * 1e9 / iterations,
+                         secs > 0 ? static_cast<double>(s.items()) / secs : 0.0, s.counters() };
+            }
+            const double factor = secs > 0 ? opt.min_time.count() * 1.4 / secs : 10.0;
+            n = std::min(max_iterations, std::max(n + 1, static_cast<std::uint64_t>(static_cast<double>(n) * std::clamp(factor, 2.0, 10.0))));
+        }
+    }
+
+    std::string json_string(const std::string& s)
+    {
+        std::string out = "\"";
+        for (char c : s) {
+            if (c == '"' || c == '\\')
+                out += '\\';
+            out += c;
+        }
+        return out + '"';
+    }
+
+    void write_json(std::ostream& os, const std::vector<result>& results, const char* executable)
+    {
+        char date[32] = "";
+        const std::time_t now = std::time(nullptr);
+        if (const std::tm* local = std::localtime(&now))
+            std::strftime(date, sizeof date, "%Y-%m-%dT%H:%M:%S", local);
+#ifdef NDEBUG
+        const char* build_type = "release";
+#else
+        const char* build_type = "debug";
+#endif
+        os.precision(10);
+        os << "{\n  \"context\": {\n"
+           << "    \"date\": " << json_string(date) << ",\n"
+           << "    \"executable\": " << json_string(executable) << ",\n"
+           << "    \"num_cpus\": " << std::thread::hardware_concurrency() << ",\n"
+           << "    \"library_build_type\": " << json_string(build_type) << "\n"
+           << "  },\n  \"benchmarks\": [";
+        for (std::size_t i = 0; i != results.size(); ++i) {
+            const result& r = results[i];
+            os << (i ? ",\n" : "\n") << "    {\n"
+               << "      \"name\": " << json_string(r.name) << ",\n"
+               << "      \"run_name\": " << json_string(r.name) << ",\n"
+               << "      \"run_type\": \"iteration\",\n"
+               << "      \"threads\": " << r.threads << ",\n"
+               << "      \"iterations\": " << r.iterations << ",\n"
+               << "      \"real_time\": " << r.real_ns << ",\n"
+               << "      \"cpu_time\": " << r.cpu_ns << ",\n"
+               << "      \"time_unit\": \"ns\",\n"
+               << "      \"items_per_second\": " << r.items_per_second;
+            for (const auto& [name, value] : r.counters)
+                os << ",\n      " << json_string(name) << ": " << value;
+            os << "\n    }";
+        }
+        os << "\n  ]\n}\n";
+    }
+
+    // ── Allocation ────────────────────────────────────────────────────────────
+
+    struct Payload {
+        std::int64_t values[6]{};
+    };
+
+    std::int64_t alloc_gc(unsigned, std::uint64_t n)
+    {
+        for (std::uint64_t i = 0; i != n; ++i) {
+            GC::New<Payload> p;
+            escape(p.get());
+        }
+        return 0;
+    }
+
+    template <ptr::meta::ThreadMode TM>
+    std::int64_t alloc_vshared(unsigned, std::uint64_t n)
+    {
+        for (std::uint64_t i = 0; i != n; ++i) {
+            auto p = ptr::VMakeShared<Payload, TM>();
+            escape(p.get());
+        }
+        return 0;
+    }
+
+    std::int64_t alloc_std(unsigned, std::uint64_t n)
+    {
+        for (std::uint64_t i = 0; i != n; ++i) {
+            auto p = std::make_shared<Payload>();
+            escape(p.get());
+        }
+        return 0;
+    }
+
+    // ── Pause times ───────────────────────────────────────────────────────────
+
+    struct TreeNode {
+        GC::Ptr<TreeNode> left;
+        GC::Ptr<TreeNode> right;
+        std::int64_t      value{ 0 };
+    };
+
+    GC::Ptr<TreeNode> build_gc_tree(int depth, std::int64_t& next)
+    {
+        GC::New<TreeNode> n;
+        n->value = next++;
+        if (depth > 0) {
+            n->left = build_gc_tree(depth - 1, next);
+            n->right = build_gc_tree(depth - 1, next);
+        }
+        return n;
+    }
+
+    /// Full collections over a live tree of 2^(depth+1) - 1 nodes, each after 10k garbage objects.
+    void pause_full(run_state& s, int depth)
+    {
+        std::int64_t next = 0;
+        GC::Ptr<TreeNode> live = build_gc_tree(depth, next);
+        GC::gc_collect();
+
+        std::vector<std::chrono::nanoseconds> pauses;
+        pauses.reserve(s.iterations);
+        GC::gc_set_callbacks({ .on_start = {}, .on_end = [&](const GC::collection_record& r) { pauses.push_back(r.pause); } });
+
+        s.start();
+        for (std::uint64_t i = 0; i != s.iterations; ++i) {
+            for (int k = 0; k != 10'000; ++k) {
+                GC::New<Payload> garbage;
+                escape(garbage.get());
+            }
+            GC::gc_collect();
+        }
+        s.stop();
+        GC::gc_set_callbacks({});
+
+        std::ranges::sort(pauses);
+        auto at = [&](double q) {
+            return pauses.empty() ? 0.0 : static_cast<double>(pauses[static_cast<std::size_t>(q * static_cast<double>(pauses.size() - 1))].count());
+        };
+        s.set_items(s.iterations);
+        s.set_counter("live_objects", static_cast<double>(next));
+        s.set_counter("pause_p50_ns", at(0.50));
+        s.set_counter("pause_p90_ns", at(0.90));
+        s.set_counter("pause_p99_ns", at(0.99));
+        s.set_counter("pause_max_ns", at(1.0));
+    }
+
+    // ── Traversal ─────────────────────────────────────────────────────────────
+
+    constexpr std::int64_t list_length = 1 << 16;
+    constexpr int          tree_depth  = 15;
+
+    struct ListNode {
+        GC::Ptr<ListNode> next;
+        std::int64_t      value{ 0 };
+    };
+
+    template <ptr::meta::ThreadMode TM>
+    struct VListNode {
+        ptr::VSharedPtr<VListNode, TM> next;
+        std::int64_t                   value{ 0 };
+    };
+
+    struct SListNode {
+        std::shared_ptr<SListNode> next;
+        std::int64_t               value{ 0 };
+    };
+
+    template <ptr::meta::ThreadMode TM>
+    struct VTreeNode {
+        ptr::VSharedPtr<VTreeNode, TM> left;
+        ptr::VSharedPtr<VTreeNode, TM> right;
+        std::int64_t                   value{ 0 };
+    };
+
+    struct STreeNode {
+        std::shared_ptr<STreeNode> left;
+        std::shared_ptr<STreeNode> right;
+        std::int64_t               value{ 0 };
+    };
+
+    GC::Ptr<ListNode> build_gc_list()
+    {
+        GC::Ptr<ListNode> head;
+        for (std::int64_t i = 0; i != list_length; ++i) {
+            GC::New<ListNode> n;
+            n->value = i;
+            n->next = head;
+            head = n;
+        }
+        return head;
+    }
+
+    template <typename Node, typename Make>
+    auto build_list(Make make)
+    {
+        decltype(make()) head;
+        for (std::int64_t i = 0; i != list_length; ++i) {
+            auto n = make();
+            n->value = i;
+            n->next = head;
+            head = n;
+        }
+        return head;
+    }
+
+    /// Unlinks a reference-counted list front to back: dropping it whole would recurse once per node.
+    template <typename P>
+    void drop_list(P& head)
+    {
+        while (head) {
+            P next = head->next;
+            head->next = P{};
+            head = next;
+        }
+    }
+
+    template <typename Node, typename Make>
+    auto build_tree(int depth, Make make, std::int64_t& next) -> decltype(make())
+    {
+        auto n = make();
+        n->value = next++;
+        if (depth > 0) {
+            n->left = build_tree<Node>(depth - 1, make, next);
+            n->right = build_tree<Node>(depth - 1, make, next);
+        }
+        return n;
+    }
+
+    /// Walks a list from @p head through handles of type P; copying them is what is measured.
+    template <typename P, typename Head>
+    std::int64_t walk_list(const Head& head, std::uint64_t n)
+    {
+        std::int64_t sum = 0;
+        for (std::uint64_t i = 0; i != n; ++i) {
+            for (P p = head; p; p = p->next)
+                sum += p->value;
+        }
+        return sum;
+    }
+
+    template <typename P>
+    std::int64_t sum_tree(const P& n)
+    {
+        if (!n)
+            return 0;
+        P left = n->left;
+        P right = n->right;
+        return n->value + sum_tree(left) + sum_tree(right);
+    }
+
+    template <typename P, typename Root>
+    std::int64_t walk_tree(const Root& root, std::uint64_t n)
+    {
+        std::int64_t sum = 0;
+        for (std::uint64_t i = 0; i != n; ++i) {
+            P p = root;
+            sum += sum_tree(p);
+        }
+        return sum;
+    }
+
+    template <ptr::meta::ThreadMode TM>
+    void walk_vshared_list(run_state& s)
+    {
+        auto head = build_list<VListNode<TM>>([] { return ptr::VMakeShared<VListNode<TM>, TM>(); });
+        run_threads(s, [&](unsigned, std::uint64_t n) { return walk_list<decltype(head)>(head, n); });
+        s.set_items(s.iterations * s.threads * list_length);
+        drop_list(head);
+    }
+
+    template <ptr::meta::ThreadMode TM>
+    void walk_vshared_tree(run_state& s)
+    {
+        std::int64_t next = 0;
+        auto root = build_tree<VTreeNode<TM>>(tree_depth, [] { return ptr::VMakeShared<VTreeNode<TM>, TM>(); }, next);
+        run_threads(s, [&](unsigned, std::uint64_t n) { return walk_tree<decltype(root)>(root, n); });
+        s.set_items(s.iterations * s.threads * ((std::uint64_t{ 2 } << tree_depth) - 1));
+    }
+
+    /// As run_threads(), adding the root count increments that took the lock.
+    template <typename F>
+    void run_counting_slow_paths(run_state& s, F&& work)
+    {
+        const std::uint64_t before = GC::gc_stats().root_slow_paths;
+        run_threads(s, work);
+        s.set_counter("root_slow_paths", static_cast<double>(GC::gc_stats().root_slow_paths - before));
+    }
+
+    // ── Contended LockedProxy ─────────────────────────────────────────────────
+
+    struct Account {
+        std::int64_t balance{ 0 };
+        void deposit(std::int64_t amount) noexcept { balance += amount; }
+    };
+
+    // ── Registry ──────────────────────────────────────────────────────────────
+
+    std::vector<benchmark> all_benchmarks(unsigned max_threads)
+    {
+        using ptr::meta::ThreadMode;
+
+        std::vector<unsigned> counts;
+        for (unsigned t = 1; t < max_threads; t *= 2)
+            counts.push_back(t);
+        counts.push_back(max_threads);
+
+        std::vector<benchmark> list;
+        auto add = [&](std::string name, unsigned threads, std::function<void(run_state&)> body) {
+            list.push_back({ std::move(name) + "/threads:" + std::to_string(threads), threads, std::move(body) });
+        };
+
+        for (unsigned t : counts) {
+            add("alloc/GC::New", t, [](run_state& s) { run_threads(s, alloc_gc); });
+            add("alloc/VMakeShared<False>", t, [](run_state& s) { run_threads(s, alloc_vshared<ThreadMode::False>); });
+            add("alloc/VMakeShared<True>", t, [](run_state& s) { run_threads(s, alloc_vshared<ThreadMode::True>); });
+            add("alloc/std::make_shared", t, [](run_state& s) { run_threads(s, alloc_std); });
+        }
+
+        for (int depth : { 12, 15, 18 })
+            add("pause/full/live:" + std::to_string((std::int64_t{ 2 } << depth) - 1), 1, [depth](run_state& s) { pause_full(s, depth); });
+
+        for (unsigned t : counts) {
+            add("traverse/list/GC::Ptr", t, [](run_state& s) {
+                GC::Ptr<ListNode> head = build_gc_list();
+                run_counting_slow_paths(s, [&](unsigned, std::uint64_t n) { return walk_list<GC::Ptr<ListNode>>(head, n); });
+                s.set_items(s.iterations * s.threads * list_length);
+            });
+            add("traverse/list/GC::Local", t, [](run_state& s) {
+                GC::Ptr<ListNode> head = build_gc_list();
+                run_counting_slow_paths(s, [&](unsigned, std::uint64_t n) { return walk_list<GC::Local<ListNode>>(head, n); });
+                s.set_items(s.iterations * s.threads * list_length);
+            });
+            // ThreadMode::False handles may not be copied on several threads at once.
+            if (t == 1)
+                add("traverse/list/VSharedPtr<False>", t, [](run_state& s) { walk_vshared_list<ThreadMode::False>(s); });
+            add("traverse/list/VSharedPtr<True>", t, [](run_state& s) { walk_vshared_list<ThreadMode::True>(s); });
+            add("traverse/list/std::shared_ptr", t, [](run_state& s) {
+                auto head = build_list<SListNode>([] { return std::make_shared<SListNode>(); });
+                run_threads(s, [&](unsigned, std::uint64_t n) { return walk_list<decltype(head)>(head, n); });
+                s.set_items(s.iterations * s.threads * list_length);
+                drop_list(head);
+            });
+
+            const std::uint64_t tree_nodes = (std::uint64_t{ 2 } << tree_depth) - 1;
+            add("traverse/tree/GC::Ptr", t, [tree_nodes](run_state& s) {
+                std::int64_t next = 0;
+                GC::Ptr<TreeNode> root = build_gc_tree(tree_depth, next);
+                run_counting_slow_paths(s, [&](unsigned, std::uint64_t n) { return walk_tree<GC::Ptr<TreeNode>>(root, n); });
+                s.set_items(s.iterations * s.threads * tree_nodes);
+            });
+            add("traverse/tree/GC::Local", t, [tree_nodes](run_state& s) {
+                std::int64_t next = 0;
+                GC::Ptr<TreeNode> root = build_gc_tree(tree_depth, next);
+                run_counting_slow_paths(s, [&](unsigned, std::uint64_t n) { return walk_tree<GC::Local<TreeNode>>(root, n); });
+                s.set_items(s.iterations * s.threads * tree_nodes);
+            });
+            if (t == 1)
+                add("traverse/tree/VSharedPtr<False>", t, [](run_state& s) { walk_vshared_tree<ThreadMode::False>(s); });
+            add("traverse/tree/VSharedPtr<True>", t, [](run_state& s) { walk_vshared_tree<ThreadMode::True>(s); });
+            add("traverse/tree/std::shared_ptr", t, [tree_nodes](run_state& s) {
+                std::int64_t next = 0;
+                auto root = build_tree<STreeNode>(tree_depth, [] { return std::make_shared<STreeNode>(); }, next);
+                run_threads(s, [&](unsigned, std::uint64_t n) { return walk_tree<decltype(root)>(root, n); });
+                s.set_items(s.iterations * s.threads * tree_nodes);
+            });
+        }
+
+        for (unsigned t : counts) {
+            add("locked/VSharedPtr::operator->", t, [](run_state& s) {
+                auto account = ptr::VMakeShared<Account>();
+                run_threads(s, [&](unsigned, std::uint64_t n) {
+                    for (std::uint64_t i = 0; i != n; ++i)
+                        account->deposit(1);
+                    return std::int64_t{ 0 };
+                });
+            });
+            add("locked/VSharedPtr::read_access", t, [](run_state& s) {
+                auto account = ptr::VMakeShared<Account>();
+                run_threads(s, [&](unsigned, std::uint64_t n) {
+                    std::int64_t sum = 0;
+                    for (std::uint64_t i = 0; i != n; ++i)
+                        sum += account.read_access()->balance;
+                    return sum;
+                });
+            });
+            add("locked/std::mutex", t, [](run_state& s) {
+                auto account = std::make_shared<Account>();
+                std::mutex mutex;
+                run_threads(s, [&](unsigned, std::uint64_t n) {
+                    for (std::uint64_t i = 0; i != n; ++i) {
+                        std::scoped_lock lock{ mutex };
+                        account->deposit(1);
+                    }
+                    return std::int64_t{ 0 };
+                });
+            });
+        }
+        return list;
+    }
+
+    bool parse(int argc, char** argv, options& opt)
+    {
+        for (int i = 1; i < argc; ++i) {
+            const std::string arg = argv[i];
+            auto value = [&](const char* flag) -> std::optional<std::string> {
+                const std::string prefix = std::string(flag) + "=";
+                if (arg.starts_with(prefix))
+                    return arg.substr(prefix.size());
+                return std::nullopt;
+            };
+            try {
+                if (auto v = value("--benchmark_filter"))
+                    opt.filter.emplace(*v);
+                else if (auto v = value("--benchmark_min_time"))
+                    opt.min_time = std::chrono::duration<double>(std::stod(*v));
+                else if (auto v = value("--benchmark_out"))
+                    opt.out = *v;
+                else if (auto v = value("--threads"))
+                    opt.max_threads = std::max(static_cast<unsigned>(std::stoul(*v)), 1u);
+                else {
+                    std::cerr << "unknown flag: " << arg << "\n";
+                    return false;
+                }
+            }
+            catch (const std::exception&) {
+                std::cerr << "bad value: " << arg << "\n";
+                return false;
+            }
+        }
+        return true;
+    }
+
+} // anonymous namespace
+
+int main(int argc, char** argv)
+{
+    options opt;
+    if (!parse(argc, argv, opt))
+        return 2;
+
+    std::vector<result> results;
+    for (const benchmark& b : all_benchmarks(opt.max_threads)) {
+        if (opt.filter && !std::regex_search(b.name, *opt.filter))
+            continue;
+        const result r = measure(b, opt);
+        std::fprintf(stderr, "%-48s %12.1f ns %14.0f items/s\n", r.name.c_str(), r.real_ns, r.items_per_second);
+        results.push_back(r);
+    }
+
+    if (opt.out.empty()) {
+        write_json(std::cout, results, argv[0]);
+        return 0;
+    }
+    std::ofstream file{ opt.out };
+    write_json(file, results, argv[0]);
+    return file ? 0 : 1;
+}
@@ -1,69 +1,70 @@
 ﻿#include "../meta.h"
-#include <memory>
-#include <iostream>
-#include <cstring>
-#include <unordered_map>
-#include <mutex>
 
-// for debug purposes only
-struct DebugDeleter {
-    void operator()(char* ptr) const noexcept {
-        std::cout << "[C++ backend] Freed memory @ "
-            << static_cast<void*>(ptr) << "\n";
-        delete[] ptr;
-    }
-};
-
-// Global registry to track shared_ptr for each allocation
-static std::unordered_map<void*, std::shared_ptr<char>> g_ptr_registry;
-static std::mutex g_registry_mutex;
+#include <limits>
+#include <new>
 
-// The real object with destructor (invisible to C)
-struct LocalPtrCpp {
-    void* raw = nullptr;
-    std::shared_ptr<char> holder;
+// The C entry points are untyped blocks on the collected heap; see
+// GC::gc_allocate_untyped().  Nothing may throw across extern "C".
+namespace {
 
-    ~LocalPtrCpp() {
-        // When this dies → shared_ptr dies → DebugDeleter prints
-        // Also clean up from registry
-        if (raw) {
-            std::lock_guard<std::mutex> lock(g_registry_mutex);
-            g_ptr_registry.erase(raw);
+    PtrBase allocate(size_t size, bool zeroed) noexcept
+    {
+        try {
+            return PtrBase{ GC::gc_allocate_untyped(size, zeroed) };
+        }
+        catch (...) {
+            return PtrBase{ nullptr };
         }
     }
-};
+
+} // anonymous namespace
 
 extern "C" {
     // allocate size bytes
     PtrBase new_malloc(size_t size) {
-        LocalPtrCpp cpp;
-        cpp.holder = std::shared_ptr<char>(new char[size], DebugDeleter{});
-        cpp.raw = cpp.holder.get();
-
-        // Register in global map
-        {
-            std::lock_guard<std::mutex> lock(g_registry_mutex);
-            g_ptr_registry[cpp.raw] = cpp.holder;
-        }
-
-        return *(PtrBase*)&cpp;
+        return allocate(size, false);
     }
 
     // allocate and zero memory
     PtrBase new_calloc(size_t count, size_t size) {
-        size_t total = count * size;
-        LocalPtrCpp cpp;
-        cpp.holder = std::shared_ptr<char>(new char[total], DebugDeleter{});
-        std::memset(cpp.holder.get(), 0, total);
-        cpp.raw = cpp.holder.get();
+        if (size != 0 && count > std::numeric_limits<size_t>::max() / size)
+            return PtrBase{ nullptr };
+        return allocate(count * size, true);
+    }
+
+    // drop a block's root; a later collection reclaims it
+    void gc_free(void* ptr) {
+        (void)GC::gc_free_untyped(ptr);
+    }
 
-        // Register in global map
-        {
-            std::lock_guard<std::mutex> lock(g_registry_mutex);
-            g_ptr_registry[cpp.raw] = cpp.holder;
+    // full collection
+    void gc_collect(void) {
+        try {
+            GC::gc_collect();
+        }
+        catch (...) {
+            // out of memory for the collector's work lists: nothing reclaimed this time
         }
+    }
 
-        return *(PtrBase*)&cpp;
+    // conservative roots from the thread stacks
+    int gc_enable_stack_scanning(void) {
+        try {
+            return GC::gc_enable_stack_scanning() ? 1 : 0;
+        }
+        catch (...) {
+            return 0;
+        }
+    }
+
+    // register the calling thread
+    void gc_register_thread(void) {
+        try {
+            GC::gc_register_thread();
+        }
+        catch (...) {
+            // out of memory: the thread registers with its first allocation instead
+        }
     }
 
-} // extern "C"
\ No newline at end of file
+} // extern "C"
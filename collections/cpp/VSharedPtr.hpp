@@ -2,6 +2,7 @@
 
 #include <atomic>
 #include <memory>
+#include <new>
 #include <type_traits>
 #include <utility>
 #include <cassert>
@@ -14,6 +15,10 @@
 #include <source_location>
 #include <compare>
 #include <cstdint>
+#include <cstring>
+#include <bit>
+#include <tuple>
+#include <vector>
 
 namespace ptr {
 
@@ -56,6 +61,15 @@ namespace ptr {
             static constexpr auto relaxed = std::memory_order_relaxed;
         };
 
+        // What a ControlBlock carries, decided at compile time
+        template<ThreadMode TM>
+        struct Layout {
+            static constexpr bool checked = safety_checks_enabled;   ///< magic words + destroyed flag
+            static constexpr bool locked  = (TM == ThreadMode::True); ///< object mutex behind LockedProxy
+            static constexpr bool packed  = (TM == ThreadMode::False); ///< 32-bit strong/weak counts sharing one word
+            static constexpr bool sequenced = locked;                  ///< seqlock counter for snapshot(), in the padding
+        };
+
     } // namespace meta
 
     // =============================================================================
@@ -80,6 +94,43 @@ namespace ptr {
         using PtrType = std::conditional_t<TM == meta::ThreadMode::True,
             std::atomic<T*>, T*>;
 
+        template<meta::ThreadMode TM>
+        using CountType = std::conditional_t<meta::Layout<TM>::packed,
+            std::uint32_t, RefCountType<TM, size_t>>;
+
+        // Stand-in for a member a layout leaves out; takes no room with [[no_unique_address]],
+        // provided each member of a class gets its own Id
+        template<int Id>
+        struct Absent {};
+
+        template<bool Present, typename T, int Id>
+        using MemberIf = std::conditional_t<Present, T, Absent<Id>>;
+
+        /**
+         * @brief Opt-in descriptor of the VSharedPtr members of T, for cycle collection.
+         *
+         * Same shape as GC::gc_pointer_map, so a type can share one list of members:
+         *
+         *     template <> struct ptr::traits::PointerMap<Node> {
+         *         static constexpr auto members = std::make_tuple(&Node::next, &Node::prev);
+         *     };
+         *
+         * Specialise it right after T, before a VSharedPtr<T> is created.
+         * ThreadMode::False objects of a mapped T are tracked by collect_cycles().
+         * A member left out of the map only hides an edge: cycles through it
+         * are not found, nothing reachable is ever freed.
+         */
+        template<typename T>
+        struct PointerMap {};
+
+        template<typename T>
+        concept PointerMapped = requires {
+            std::tuple_size<std::remove_cvref_t<decltype(PointerMap<T>::members)>>::value;
+        };
+
+        template<typename T, meta::ThreadMode TM>
+        inline constexpr bool cycle_tracked = (TM == meta::ThreadMode::False) && PointerMapped<T>;
+
     } // namespace traits
 
     // =============================================================================
@@ -128,27 +179,43 @@ namespace ptr {
         // =========================================================================
         // LockedProxy  RAII exclusive-lock wrapper returned by operator->
         // =========================================================================
+        // A non-null `seq` is the object's seqlock counter: odd while the proxy
+        // lives, so that snapshot() readers retry.
         template<typename T>
         class LockedProxy {
             T* ptr_;
             std::unique_lock<std::shared_mutex>   lock_;
+            std::atomic<std::uint32_t>*           seq_;
         public:
-            LockedProxy(T* ptr, std::shared_mutex& mtx)
-                : ptr_(ptr), lock_(mtx)
+            LockedProxy(T* ptr, std::shared_mutex& mtx, std::atomic<std::uint32_t>* seq = nullptr)
+                : ptr_(ptr), lock_(mtx), seq_(seq)
             {
                 if (!ptr_) exception::throw_or_abort("LockedProxy: null pointer");
+                if (seq_) {
+                    seq_->fetch_add(1, std::memory_order_relaxed);
+                    std::atomic_thread_fence(std::memory_order_release);
+                }
+            }
+
+            ~LockedProxy() {
+                if (seq_) seq_->fetch_add(1, std::memory_order_release);
             }
 
             LockedProxy(const LockedProxy&) = delete;
             LockedProxy& operator=(const LockedProxy&) = delete;
 
             LockedProxy(LockedProxy&& o) noexcept
-                : ptr_(o.ptr_), lock_(std::move(o.lock_)) {
+                : ptr_(o.ptr_), lock_(std::move(o.lock_)), seq_(o.seq_) {
                 o.ptr_ = nullptr;
+                o.seq_ = nullptr;
             }
 
             LockedProxy& operator=(LockedProxy&& o) noexcept {
-                if (this != &o) { ptr_ = o.ptr_; lock_ = std::move(o.lock_); o.ptr_ = nullptr; }
+                if (this != &o) {
+                    if (seq_) seq_->fetch_add(1, std::memory_order_release);
+                    ptr_ = o.ptr_; lock_ = std::move(o.lock_); seq_ = o.seq_;
+                    o.ptr_ = nullptr; o.seq_ = nullptr;
+                }
                 return *this;
             }
 
@@ -158,31 +225,266 @@ namespace ptr {
             [[nodiscard]] explicit operator bool() const noexcept { return ptr_ != nullptr; }
         };
 
+        // =========================================================================
+        // SharedProxy  RAII shared-lock wrapper returned by read_access()
+        // =========================================================================
+        template<typename T>
+        class SharedProxy {
+            const T* ptr_;
+            std::shared_lock<std::shared_mutex>   lock_;
+        public:
+            SharedProxy(const T* ptr, std::shared_mutex& mtx)
+                : ptr_(ptr), lock_(mtx)
+            {
+                if (!ptr_) exception::throw_or_abort("SharedProxy: null pointer");
+            }
+
+            SharedProxy(const SharedProxy&) = delete;
+            SharedProxy& operator=(const SharedProxy&) = delete;
+
+            SharedProxy(SharedProxy&& o) noexcept
+                : ptr_(o.ptr_), lock_(std::move(o.lock_)) {
+                o.ptr_ = nullptr;
+            }
+
+            SharedProxy& operator=(SharedProxy&& o) noexcept {
+                if (this != &o) { ptr_ = o.ptr_; lock_ = std::move(o.lock_); o.ptr_ = nullptr; }
+                return *this;
+            }
+
+            [[nodiscard]] const T* operator->() const noexcept { assert(ptr_); return ptr_; }
+            [[nodiscard]] const T& operator*()  const noexcept { assert(ptr_); return *ptr_; }
+            [[nodiscard]] const T* get()        const noexcept { return ptr_; }
+            [[nodiscard]] explicit operator bool() const noexcept { return ptr_ != nullptr; }
+        };
+
+        // =========================================================================
+        // Cycle collection  synchronous trial deletion (Bacon & Rajan)
+        // =========================================================================
+        // A strong release that leaves the count above zero may have cut the
+        // last outside edge into a cycle: the block is buffered as a candidate
+        // root. collect_cycles() then, per batch of candidates, subtracts the
+        // edges internal to the subgraph they reach (mark_gray), restores what
+        // is still counted from outside (scan / scan_black), and destroys the
+        // rest. Only ThreadMode::False blocks take part: the trial counts would
+        // race with other threads' copies and lock() calls.
+        enum class CycleColor : std::uint8_t {
+            black,    ///< in use, or not yet looked at
+            gray,     ///< trial-decremented, undecided
+            white,    ///< counted from inside its subgraph only
+            purple,   ///< candidate root
+            garbage   ///< being destroyed by the collector; no longer a candidate
+        };
+
+        struct CycleNode;
+
+        // Per-type operations on a tracked block, reached through CycleNode::ops
+        struct CycleOps {
+            std::uint32_t& (*strong)(CycleNode*) noexcept;
+            void (*children)(CycleNode*, std::vector<CycleNode*>&);   ///< appends the strong edges out of the object
+            void (*destroy_object)(CycleNode*) noexcept;
+            void (*release_strong)(CycleNode*) noexcept;
+            void (*dispose_unreferenced)(CycleNode*) noexcept;         ///< free a dead block unless weak handles remain
+        };
+
+        // Base of ControlBlock<T, ThreadMode::False> for a PointerMapped T
+        struct CycleNode {
+            const CycleOps* ops = nullptr;
+            CycleColor      color = CycleColor::black;
+            bool            buffered = false;                    ///< in the candidate buffer, which keeps the block allocated
+        };
+
+        // Candidates of the calling thread, as ThreadMode::False objects belong to one thread at a time
+        struct CycleBuffer {
+            std::vector<CycleNode*> roots;
+            size_t                  threshold = 4096;            ///< collect once this many are buffered; 0: on request only
+            bool                    collecting = false;
+
+            ~CycleBuffer();
+        };
+
+        inline thread_local CycleBuffer cycle_buffer;
+        inline thread_local bool        cycle_buffer_closed = false;   ///< past ~CycleBuffer at thread exit
+
+        size_t collect_cycles() noexcept;
+
+        // ---- phases ---------------------------------------------------------
+
+        inline void mark_gray(CycleNode* s, std::vector<CycleNode*>& stack, std::vector<CycleNode*>& kids) {
+            if (s->color == CycleColor::gray) return;
+            s->color = CycleColor::gray;
+            stack.push_back(s);
+            while (!stack.empty()) {
+                CycleNode* n = stack.back();
+                stack.pop_back();
+                kids.clear();
+                n->ops->children(n, kids);
+                for (CycleNode* c : kids) {
+                    --c->ops->strong(c);
+                    if (c->color != CycleColor::gray) { c->color = CycleColor::gray; stack.push_back(c); }
+                }
+            }
+        }
+
+        inline void scan_black(CycleNode* s, std::vector<CycleNode*>& stack, std::vector<CycleNode*>& kids) {
+            s->color = CycleColor::black;
+            stack.push_back(s);
+            while (!stack.empty()) {
+                CycleNode* n = stack.back();
+                stack.pop_back();
+                kids.clear();
+                n->ops->children(n, kids);
+                for (CycleNode* c : kids) {
+                    ++c->ops->strong(c);
+                    if (c->color != CycleColor::black) { c->color = CycleColor::black; stack.push_back(c); }
+                }
+            }
+        }
+
+        inline void scan(CycleNode* s, std::vector<CycleNode*>& stack, std::vector<CycleNode*>& kids) {
+            std::vector<CycleNode*> pending{ s };
+            while (!pending.empty()) {
+                CycleNode* n = pending.back();
+                pending.pop_back();
+                if (n->color != CycleColor::gray) continue;
+                if (n->ops->strong(n) > 0) { scan_black(n, stack, kids); continue; }
+                n->color = CycleColor::white;
+                kids.clear();
+                n->ops->children(n, kids);
+                pending.insert(pending.end(), kids.begin(), kids.end());
+            }
+        }
+
+        inline void collect_white(CycleNode* s, std::vector<CycleNode*>& garbage, std::vector<CycleNode*>& kids) {
+            std::vector<CycleNode*> pending{ s };
+            while (!pending.empty()) {
+                CycleNode* n = pending.back();
+                pending.pop_back();
+                if (n->color != CycleColor::white || n->buffered) continue;
+                n->color = CycleColor::garbage;
+                garbage.push_back(n);
+                kids.clear();
+                n->ops->children(n, kids);
+                pending.insert(pending.end(), kids.begin(), kids.end());
+            }
+        }
+
+        // The strong count of `n` stayed above zero
+        inline void possible_root(CycleNode* n) noexcept {
+            if (n->color == CycleColor::garbage) return;   // the collector holds it
+            n->color = CycleColor::purple;
+            if (n->buffered || cycle_buffer_closed) return;
+            CycleBuffer& b = cycle_buffer;
+            try {
+                b.roots.push_back(n);
+            }
+            catch (...) {
+                return;   // not tracked this time; a later release can buffer it again
+            }
+            n->buffered = true;
+            if (b.threshold != 0 && b.roots.size() >= b.threshold)
+                collect_cycles();
+        }
+
+        // noexcept: out of memory for the work lists mid-run would leave trial
+        // counts behind, so it terminates rather than unwind
+        inline size_t collect_cycles() noexcept {
+            CycleBuffer& b = cycle_buffer;
+            if (b.collecting) return 0;   // reached from a destructor the collector runs
+            b.collecting = true;
+
+            std::vector<CycleNode*> roots;
+            roots.swap(b.roots);
+            std::vector<CycleNode*> stack, kids, garbage;
+
+            // Trial-delete the edges internal to what the candidates reach
+            size_t kept = 0;
+            for (CycleNode* n : roots) {
+                if (n->color == CycleColor::purple && n->ops->strong(n) > 0) {
+                    mark_gray(n, stack, kids);
+                    roots[kept++] = n;
+                    continue;
+                }
+                n->buffered = false;
+                if (n->color == CycleColor::black && n->ops->strong(n) == 0)
+                    n->ops->dispose_unreferenced(n);   // died while buffered
+            }
+            roots.resize(kept);
+
+            for (CycleNode* n : roots) scan(n, stack, kids);
+            for (CycleNode* n : roots) n->buffered = false;
+            for (CycleNode* n : roots) collect_white(n, garbage, kids);
+
+            // Put the internal edges back and hold every block with one more
+            // reference, so the destructors below release each other's
+            // members without freeing a block under the collector; then drop
+            // the holds, which frees what no weak handle still names.
+            for (CycleNode* n : garbage) {
+                kids.clear();
+                n->ops->children(n, kids);
+                for (CycleNode* c : kids)
+                    if (c->color == CycleColor::garbage) ++c->ops->strong(c);
+            }
+            for (CycleNode* n : garbage) ++n->ops->strong(n);
+            for (CycleNode* n : garbage) n->ops->destroy_object(n);
+            for (CycleNode* n : garbage) n->ops->release_strong(n);
+            b.collecting = false;
+            return garbage.size();
+        }
+
+        // The thread's last candidates; what their destructors release is buffered and run in turn
+        inline CycleBuffer::~CycleBuffer() {
+            while (!roots.empty()) collect_cycles();
+            cycle_buffer_closed = true;
+        }
+
+        template<typename T>
+        struct CycleAccess;   // enumerates the edges of a T; defined after VSharedPtr
+
+        // =========================================================================
+        // Fused arrays  element construction
+        // =========================================================================
+
+        // p[0, count), value- or default-initialized; none is left constructed if one throws
+        template<typename T, bool Value>
+        void construct_elements(T* p, size_t count) {
+            if constexpr (Value) std::uninitialized_value_construct_n(p, count);
+            else                 std::uninitialized_default_construct_n(p, count);
+        }
+
         // =========================================================================
         // ControlBlock  reference counting + managed object lifetime
         // =========================================================================
         template<typename T, meta::ThreadMode TM>
-        class ControlBlock {
+        class ControlBlock
+            : public std::conditional_t<traits::cycle_tracked<T, TM>, CycleNode, traits::Absent<5>> {
             using MO = meta::MemoryOrder<TM>;
+            using Layout = meta::Layout<TM>;
+            static constexpr bool tracked = traits::cycle_tracked<T, TM>;
+
+            // Corruption detection  compiled in with the safety checks only
+            [[no_unique_address]] traits::MemberIf<Layout::checked, uint64_t, 0> magic_header_;
 
-            // Ref counts  separate to avoid false sharing
-            alignas(64) traits::RefCountType<TM, size_t> gc_strong_count_;
-            alignas(64) traits::RefCountType<TM, size_t> gc_weak_count_;
+            // Ref counts  adjacent for a smaller block, at the price of false sharing
+            // when one thread updates the strong count while another updates the weak
+            traits::CountType<TM>                        gc_strong_count_;
+            traits::CountType<TM>                        gc_weak_count_;
             traits::PtrType<TM, T>                       ptr_;
+            const size_t                                 fused_count_;   // elements stored after the block, if fused_
             traits::RefCountType<TM, bool>               object_destroyed_;
             const bool                                   is_array_;
+            const bool                                   fused_;         // object stored after the block, in its allocation
+            [[no_unique_address]] mutable traits::MemberIf<Layout::sequenced, std::atomic<std::uint32_t>, 4> seq_;
 
             // Protects object access; upgrade to exclusive for destruction
-            mutable std::shared_mutex object_mutex_;
+            [[no_unique_address]] mutable traits::MemberIf<Layout::locked, std::shared_mutex, 1> object_mutex_;
 
-            // Corruption detection  always compiled in, gated at runtime
-            uint64_t                  magic_header_{ meta::magic::alive };
-            uint64_t                  magic_footer_{ meta::magic::alive };
-            std::atomic<bool>         control_block_destroyed_{ false };
+            [[no_unique_address]] traits::MemberIf<Layout::checked, uint64_t, 2>          magic_footer_;
+            [[no_unique_address]] traits::MemberIf<Layout::checked, std::atomic<bool>, 3> control_block_destroyed_;
 
             // ---- helpers --------------------------------------------------------
 
-            [[nodiscard]] size_t load_count(const traits::RefCountType<TM, size_t>& c) const noexcept {
+            [[nodiscard]] size_t load_count(const traits::CountType<TM>& c) const noexcept {
                 if constexpr (TM == meta::ThreadMode::True)
                     return c.load(MO::acquire);
                 else
@@ -210,12 +512,13 @@ namespace ptr {
             }
 
             void verify_integrity() const {
-                if (!meta::safety_checks_enabled) return;
-                if (magic_header_ != meta::magic::alive ||
-                    magic_footer_ != meta::magic::alive)
-                    throw exception::MemorySafety("ControlBlock: corruption detected!");
-                if (control_block_destroyed_.load(std::memory_order_acquire))
-                    throw exception::MemorySafety("ControlBlock: already destroyed!");
+                if constexpr (Layout::checked) {
+                    if (magic_header_ != meta::magic::alive ||
+                        magic_footer_ != meta::magic::alive)
+                        throw exception::MemorySafety("ControlBlock: corruption detected!");
+                    if (control_block_destroyed_.load(std::memory_order_acquire))
+                        throw exception::MemorySafety("ControlBlock: already destroyed!");
+                }
             }
 
             void destroy_object() noexcept {
@@ -235,30 +538,158 @@ namespace ptr {
 
                 // Upgrade: acquire exclusive lock before touching the object.
                 // Readers hold shared_lock; we wait for them to drain.
-                {
+                if constexpr (Layout::locked) {
                     std::unique_lock lock(object_mutex_);
-                    T* p = exchange_ptr_impl(nullptr);
-                    if (p) {
-                        if (is_array_) delete[] p;
-                        else           delete p;
-                    }
+                    delete_object(exchange_ptr_impl(nullptr));
+                }
+                else {
+                    delete_object(exchange_ptr_impl(nullptr));
                 }
             }
 
-        public:
-            explicit ControlBlock(T* p, bool is_array = false) noexcept
+            void delete_object(T* p) noexcept {
+                if (!p) return;
+                if (fused_) {
+                    // In place; the storage goes with the block. Reverse order, as delete[].
+                    for (size_t i = fused_count_; i-- > 0;)
+                        std::destroy_at(p + i);
+                }
+                else if (is_array_) delete[] p;
+                else                delete p;
+            }
+
+            // Last reference of either kind gone: free the block, and a fused object's storage with it
+            void dispose() noexcept {
+                if (!fused_) { delete this; return; }
+                const size_t bytes = fused_bytes(fused_count_);
+                void* mem = this;
+                this->~ControlBlock();
+                ::operator delete(mem, bytes, std::align_val_t{ fused_align() });
+            }
+
+            // ---- fused layout: [ControlBlock | padding | T or T[n]] -------------
+
+            [[nodiscard]] static constexpr size_t fused_align() noexcept {
+                return alignof(ControlBlock) > alignof(T) ? alignof(ControlBlock) : alignof(T);
+            }
+            [[nodiscard]] static constexpr size_t fused_offset() noexcept {
+                return (sizeof(ControlBlock) + alignof(T) - 1) / alignof(T) * alignof(T);
+            }
+            [[nodiscard]] static constexpr size_t fused_bytes(size_t count) noexcept {
+                return fused_offset() + count * sizeof(T);
+            }
+
+            // ---- cycle collection: CycleOps of a tracked block ------------------
+
+            [[nodiscard]] static ControlBlock* self(CycleNode* n) noexcept { return static_cast<ControlBlock*>(n); }
+
+            static void cycle_children(CycleNode* n, std::vector<CycleNode*>& out) {
+                ControlBlock* c = self(n);
+                if (T* p = c->load_ptr()) {
+                    // An array of unknown length shows no edges, which only ever keeps it
+                    const size_t count = c->fused_ ? c->fused_count_ : (c->is_array_ ? 0 : 1);
+                    for (size_t i = 0; i < count; ++i)
+                        CycleAccess<T>::children(p[i], out);
+                }
+            }
+
+            static void cycle_dispose_unreferenced(CycleNode* n) noexcept {
+                ControlBlock* c = self(n);
+                if (c->load_count(c->gc_weak_count_) == 0) c->dispose();
+            }
+
+            [[nodiscard]] static const CycleOps* cycle_ops() noexcept {
+                static constexpr CycleOps ops{
+                    [](CycleNode* n) noexcept -> std::uint32_t& { return self(n)->gc_strong_count_; },
+                    &cycle_children,
+                    [](CycleNode* n) noexcept { self(n)->destroy_object(); },
+                    [](CycleNode* n) noexcept { self(n)->release_strong(); },
+                    &cycle_dispose_unreferenced,
+                };
+                return &ops;
+            }
+
+            ControlBlock(T* p, bool is_array, bool fused, size_t fused_count) noexcept
                 : gc_strong_count_(1)
                 , gc_weak_count_(0)
                 , ptr_(p)
+                , fused_count_(fused_count)
                 , object_destroyed_(false)
                 , is_array_(is_array)
+                , fused_(fused)
+            {
+                if constexpr (Layout::sequenced)
+                    seq_.store(0, std::memory_order_relaxed);
+                if constexpr (tracked)
+                    this->ops = cycle_ops();
+                if constexpr (Layout::checked) {
+                    magic_header_ = meta::magic::alive;
+                    magic_footer_ = meta::magic::alive;
+                    control_block_destroyed_.store(false, std::memory_order_relaxed);
+                }
+            }
+
+        public:
+            explicit ControlBlock(T* p, bool is_array = false) noexcept
+                : ControlBlock(p, is_array, false, 0)
             {
             }
 
+            /// One allocation for the block and a T built from `args` (VMakeShared)
+            template<typename... Args>
+            [[nodiscard]] static ControlBlock* make_fused(Args&&... args) {
+                void* mem = ::operator new(fused_bytes(1), std::align_val_t{ fused_align() });
+                T* p = nullptr;
+                try {
+                    p = ::new (static_cast<char*>(mem) + fused_offset()) T(std::forward<Args>(args)...);
+                }
+                catch (...) {
+                    ::operator delete(mem, fused_bytes(1), std::align_val_t{ fused_align() });
+                    throw;
+                }
+                return ::new (mem) ControlBlock(p, false, true, 1);
+            }
+
+            /// As make_fused(), default-initialized (VMakeSharedForOverwrite)
+            [[nodiscard]] static ControlBlock* make_fused_for_overwrite() {
+                void* mem = ::operator new(fused_bytes(1), std::align_val_t{ fused_align() });
+                T* p = nullptr;
+                try {
+                    p = ::new (static_cast<char*>(mem) + fused_offset()) T;
+                }
+                catch (...) {
+                    ::operator delete(mem, fused_bytes(1), std::align_val_t{ fused_align() });
+                    throw;
+                }
+                return ::new (mem) ControlBlock(p, false, true, 1);
+            }
+
+            /// One allocation for the block and `count` value-initialized elements (VMakeShared<T[]>),
+            /// default-initialized if !Value (VMakeSharedForOverwrite<T[]>)
+            template<bool Value = true>
+            [[nodiscard]] static ControlBlock* make_fused_array(size_t count) {
+                if (count > (SIZE_MAX - fused_offset()) / sizeof(T))
+                    throw std::bad_array_new_length();
+                const size_t bytes = fused_bytes(count);
+                void* mem = ::operator new(bytes, std::align_val_t{ fused_align() });
+                T* p = reinterpret_cast<T*>(static_cast<char*>(mem) + fused_offset());
+                try {
+                    construct_elements<T, Value>(p, count);
+                }
+                catch (...) {
+                    ::operator delete(mem, bytes, std::align_val_t{ fused_align() });
+                    throw;
+                }
+                // A zero-length array has no element to launder; it still gets its own block
+                return ::new (mem) ControlBlock(count != 0 ? std::launder(p) : p, true, true, count);
+            }
+
             ~ControlBlock() {
-                control_block_destroyed_.store(true, std::memory_order_release);
-                magic_header_ = meta::magic::destroyed;
-                magic_footer_ = meta::magic::destroyed;
+                if constexpr (Layout::checked) {
+                    control_block_destroyed_.store(true, std::memory_order_release);
+                    magic_header_ = meta::magic::destroyed;
+                    magic_footer_ = meta::magic::destroyed;
+                }
             }
 
             ControlBlock(const ControlBlock&) = delete;
@@ -274,6 +705,15 @@ namespace ptr {
                     ++gc_strong_count_;
             }
 
+            // `n` references at once, as AtomicVSharedPtr hands over its readers' claims
+            void add_strong(size_t n) {
+                verify_integrity();
+                if constexpr (TM == meta::ThreadMode::True)
+                    gc_strong_count_.fetch_add(n, MO::relaxed);
+                else
+                    gc_strong_count_ += static_cast<traits::CountType<TM>>(n);
+            }
+
             void add_weak() {
                 verify_integrity();
                 if constexpr (TM == meta::ThreadMode::True)
@@ -313,6 +753,8 @@ namespace ptr {
                     // Synchronize with all prior releases
                     if constexpr (TM == meta::ThreadMode::True)
                         std::atomic_thread_fence(MO::acquire);
+                    if constexpr (tracked)
+                        this->color = CycleColor::black;
 
                     destroy_object();
 
@@ -321,9 +763,14 @@ namespace ptr {
                     if (weak == 0) {
                         if constexpr (TM == meta::ThreadMode::True)
                             std::atomic_thread_fence(MO::acquire);
-                        delete this; // safe  we are the last reference
+                        if constexpr (tracked)
+                            if (this->buffered) return;   // collect_cycles() frees it
+                        dispose(); // safe  we are the last reference
                     }
                 }
+                else if constexpr (tracked) {
+                    possible_root(this);
+                }
             }
 
             // FIX: read strong_count BEFORE the potential `delete this` path
@@ -345,7 +792,9 @@ namespace ptr {
                     if (strong == 0) {
                         if constexpr (TM == meta::ThreadMode::True)
                             std::atomic_thread_fence(MO::acquire);
-                        delete this;
+                        if constexpr (tracked)
+                            if (this->buffered) return;   // collect_cycles() frees it
+                        dispose();
                     }
                 }
             }
@@ -355,15 +804,44 @@ namespace ptr {
             [[nodiscard]] size_t        strong_count()  const noexcept { return load_count(gc_strong_count_); }
             [[nodiscard]] size_t        weak_count()    const noexcept { return load_count(gc_weak_count_); }
             [[nodiscard]] bool          is_array()      const noexcept { return is_array_; }
-            [[nodiscard]] std::shared_mutex& get_mutex() const noexcept { return object_mutex_; }
+            [[nodiscard]] bool          is_fused()      const noexcept { return fused_; }
+            [[nodiscard]] std::shared_mutex& get_mutex() const noexcept requires Layout::locked { return object_mutex_; }
+            [[nodiscard]] std::atomic<std::uint32_t>& get_seq() const noexcept requires Layout::sequenced { return seq_; }
         };
 
+        // The release layout of ThreadMode::False fits in four words
+        static_assert(meta::Layout<meta::ThreadMode::False>::checked
+            || sizeof(ControlBlock<int, meta::ThreadMode::False>) <= 4 * sizeof(void*));
+
     } // namespace detail
 
     // =============================================================================
     // VSharedPtr  main smart pointer
     // =============================================================================
     template<typename T, meta::ThreadMode TM = meta::ThreadMode::True>
+    class VSharedPtr;
+
+    template<typename T, meta::ThreadMode TM = meta::ThreadMode::True>
+        requires (TM == meta::ThreadMode::True)
+    class AtomicVSharedPtr;
+
+    template<typename T, meta::ThreadMode TM = meta::ThreadMode::True, typename... Args>
+        requires traits::NotArray<T>
+    [[nodiscard]] VSharedPtr<T, TM> VMakeShared(Args&&... args);
+
+    template<typename T, meta::ThreadMode TM = meta::ThreadMode::True>
+        requires traits::IsUnboundedArray<T>
+    [[nodiscard]] VSharedPtr<T, TM> VMakeShared(size_t count);
+
+    template<typename T, meta::ThreadMode TM = meta::ThreadMode::True>
+        requires traits::NotArray<T>
+    [[nodiscard]] VSharedPtr<T, TM> VMakeSharedForOverwrite();
+
+    template<typename T, meta::ThreadMode TM = meta::ThreadMode::True>
+        requires traits::IsUnboundedArray<T>
+    [[nodiscard]] VSharedPtr<T, TM> VMakeSharedForOverwrite(size_t count);
+
+    template<typename T, meta::ThreadMode TM>
     class VSharedPtr {
     public:
         using element_type = std::remove_extent_t<T>;
@@ -373,56 +851,87 @@ namespace ptr {
     private:
         using Elem = element_type;
         using CB = detail::ControlBlock<Elem, TM>;
-        using MO = meta::MemoryOrder<TM>;
 
-        traits::PtrType<TM, CB>      ctrl_;
-        traits::RefCountType<TM, bool> is_weak_;
+        // A single plain word in either ThreadMode: the control block, with the
+        // weak flag in bit 0. Only the counts behind it are atomic, so a handle
+        // may be copied by many threads but mutated by one at a time, as a
+        // std::shared_ptr; AtomicVSharedPtr is the slot for shared mutation.
+        static constexpr std::uintptr_t weak_bit = 1;
+
+        std::uintptr_t handle_{ 0 };
 
         explicit VSharedPtr(CB* ctrl, bool is_weak) noexcept
-            : ctrl_(ctrl), is_weak_(is_weak) {
+            : handle_(pack(ctrl, is_weak)) {
         }
 
         template<typename U, meta::ThreadMode TM2> friend class VSharedPtr;
 
-        // ---- atomic/plain load/store/exchange helpers --------------------------
-        [[nodiscard]] CB* load_ctrl() const noexcept {
-            if constexpr (TM == meta::ThreadMode::True) return ctrl_.load(MO::acquire);
-            else return ctrl_;
-        }
-        void store_ctrl(CB* c) noexcept {
-            if constexpr (TM == meta::ThreadMode::True) ctrl_.store(c, MO::release);
-            else ctrl_ = c;
-        }
-        CB* exchange_ctrl(CB* c) noexcept {
-            if constexpr (TM == meta::ThreadMode::True) return ctrl_.exchange(c, MO::acq_rel);
-            else { CB* old = ctrl_; ctrl_ = c; return old; }
-        }
-        [[nodiscard]] bool load_weak() const noexcept {
-            if constexpr (TM == meta::ThreadMode::True) return is_weak_.load(MO::acquire);
-            else return is_weak_;
+        template<typename U, meta::ThreadMode TM2>
+            requires (TM2 == meta::ThreadMode::True)
+        friend class AtomicVSharedPtr;
+
+        template<typename U> friend struct detail::CycleAccess;
+
+        template<typename U, meta::ThreadMode TM2, typename... Args>
+            requires traits::NotArray<U>
+        friend VSharedPtr<U, TM2> VMakeShared(Args&&... args);
+
+        template<typename U, meta::ThreadMode TM2>
+            requires traits::IsUnboundedArray<U>
+        friend VSharedPtr<U, TM2> VMakeShared(size_t count);
+
+        template<typename U, meta::ThreadMode TM2>
+            requires traits::NotArray<U>
+        friend VSharedPtr<U, TM2> VMakeSharedForOverwrite();
+
+        template<typename U, meta::ThreadMode TM2>
+            requires traits::IsUnboundedArray<U>
+        friend VSharedPtr<U, TM2> VMakeSharedForOverwrite(size_t count);
+
+        // ---- handle word helpers ------------------------------------------------
+        // CB is completed from member bodies only, so that a T holding a
+        // VSharedPtr<T> can still specialise traits::PointerMap after its definition
+        [[nodiscard]] static std::uintptr_t pack(CB* c, bool weak) noexcept {
+            static_assert(alignof(CB) > weak_bit, "ControlBlock alignment leaves no room for the weak bit");
+            return reinterpret_cast<std::uintptr_t>(c) | (weak ? weak_bit : 0);
         }
-        void store_weak(bool w) noexcept {
-            if constexpr (TM == meta::ThreadMode::True) is_weak_.store(w, MO::release);
-            else is_weak_ = w;
+        [[nodiscard]] CB* load_ctrl() const noexcept { return reinterpret_cast<CB*>(handle_ & ~weak_bit); }
+        [[nodiscard]] bool load_weak() const noexcept { return (handle_ & weak_bit) != 0; }
+        void store(CB* c, bool weak) noexcept { handle_ = pack(c, weak); }
+        [[nodiscard]] std::uintptr_t take() noexcept { return std::exchange(handle_, 0); }
+
+        // One more reference of the kind this handle holds
+        void retain() const {
+            if (CB* c = load_ctrl()) {
+                if (load_weak()) c->add_weak();
+                else             c->add_strong();
+            }
         }
-        bool exchange_weak(bool w) noexcept {
-            if constexpr (TM == meta::ThreadMode::True) return is_weak_.exchange(w, MO::acq_rel);
-            else { bool old = is_weak_; is_weak_ = w; return old; }
+
+        // Writers of a trivially copyable T keep the seqlock that snapshot() reads
+        [[nodiscard]] static detail::LockedProxy<Elem> exclusive(CB* c) {
+            if constexpr (std::is_trivially_copyable_v<Elem>)
+                return detail::LockedProxy<Elem>(c->get_ptr(), c->get_mutex(), &c->get_seq());
+            else
+                return detail::LockedProxy<Elem>(c->get_ptr(), c->get_mutex());
         }
 
+        // Clears the handle before the count drops, so that no destructor or
+        // collect_cycles() run from the release sees it still naming the block
         void release() noexcept {
-            if (CB* c = load_ctrl()) {
-                if (load_weak()) c->release_weak();
-                else             c->release_strong();
+            const bool weak = load_weak();
+            if (CB* c = reinterpret_cast<CB*>(take() & ~weak_bit)) {
+                if (weak) c->release_weak();
+                else      c->release_strong();
             }
         }
 
     public:
         // ---- constructors -------------------------------------------------------
-        constexpr VSharedPtr() noexcept : ctrl_(nullptr), is_weak_(false) {}
-        constexpr VSharedPtr(std::nullptr_t) noexcept : ctrl_(nullptr), is_weak_(false) {}
+        constexpr VSharedPtr() noexcept = default;
+        constexpr VSharedPtr(std::nullptr_t) noexcept {}
 
-        explicit VSharedPtr(Elem* ptr) : ctrl_(nullptr), is_weak_(false) {
+        explicit VSharedPtr(Elem* ptr) {
             if (!ptr) return;
             constexpr bool arr = std::is_array_v<T>;
             CB* cb = nullptr;
@@ -434,22 +943,12 @@ namespace ptr {
                 else               delete ptr;
                 throw;
             }
-            store_ctrl(cb);
+            store(cb, false);
         }
 
-        VSharedPtr(const VSharedPtr& o) noexcept : ctrl_(nullptr), is_weak_(false) {
-            CB* c = o.load_ctrl();
-            bool w = o.load_weak();
-            if (c) { if (w) c->add_weak(); else c->add_strong(); }
-            store_ctrl(c);
-            store_weak(w);
-        }
+        VSharedPtr(const VSharedPtr& o) noexcept : handle_(o.handle_) { retain(); }
 
-        VSharedPtr(VSharedPtr&& o) noexcept
-            : ctrl_(o.exchange_ctrl(nullptr))
-            , is_weak_(o.exchange_weak(false))
-        {
-        }
+        VSharedPtr(VSharedPtr&& o) noexcept : handle_(o.take()) {}
 
         // Cross-type copy (same ThreadMode, compatible pointers, no UB reinterpret_cast)
         // We restrict this to T == U or U* -> T* for same Elem type to avoid UB.
@@ -457,21 +956,15 @@ namespace ptr {
             requires traits::ConvertiblePtr<std::remove_extent_t<U>, Elem>
         && (TM == TM2)
             && std::is_same_v<std::remove_extent_t<U>, Elem>
-            VSharedPtr(const VSharedPtr<U, TM2>& o) noexcept : ctrl_(nullptr), is_weak_(false) {
-            CB* c = reinterpret_cast<CB*>(o.load_ctrl()); // safe: same Elem type
-            bool w = o.load_weak();
-            if (c) { if (w) c->add_weak(); else c->add_strong(); }
-            store_ctrl(c);
-            store_weak(w);
+            VSharedPtr(const VSharedPtr<U, TM2>& o) noexcept : handle_(o.handle_) { // safe: same Elem type, same CB
+            retain();
         }
 
         template<typename U, meta::ThreadMode TM2>
             requires traits::ConvertiblePtr<std::remove_extent_t<U>, Elem>
         && (TM == TM2)
             && std::is_same_v<std::remove_extent_t<U>, Elem>
-            VSharedPtr(VSharedPtr<U, TM2>&& o) noexcept : ctrl_(nullptr), is_weak_(false) {
-            store_ctrl(reinterpret_cast<CB*>(o.exchange_ctrl(nullptr)));
-            store_weak(o.exchange_weak(false));
+            VSharedPtr(VSharedPtr<U, TM2>&& o) noexcept : handle_(o.take()) {
         }
 
         ~VSharedPtr() { release(); }
@@ -482,7 +975,7 @@ namespace ptr {
             return *this;
         }
         VSharedPtr& operator=(VSharedPtr&& o) noexcept {
-            if (this != &o) { release(); store_ctrl(o.exchange_ctrl(nullptr)); store_weak(o.exchange_weak(false)); }
+            if (this != &o) { release(); handle_ = o.take(); }
             return *this;
         }
         VSharedPtr& operator=(std::nullptr_t) noexcept { reset(); return *this; }
@@ -495,7 +988,7 @@ namespace ptr {
             if (w)  exception::throw_or_abort("operator->: cannot dereference weak pointer");
             if (!c) exception::throw_or_abort("operator->: null pointer dereference");
             if constexpr (TM == meta::ThreadMode::True)
-                return detail::LockedProxy<Elem>(c->get_ptr(), c->get_mutex());
+                return exclusive(c);
             else
                 return c->get_ptr();
         }
@@ -544,9 +1037,56 @@ namespace ptr {
             bool w = load_weak();
             if (w)  exception::throw_or_abort("lock_access: called on weak pointer");
             if (!c) exception::throw_or_abort("lock_access: called on null pointer");
-            return detail::LockedProxy<Elem>(c->get_ptr(), c->get_mutex());
+            return exclusive(c);
         }
 
+        /// Read-only access under a shared lock: readers run concurrently, writers
+        /// (operator->, lock_access) wait. operator-> stays exclusive, as a const
+        /// handle does not make the object const.
+        template<meta::ThreadMode M = TM>
+            requires (M == meta::ThreadMode::True) && traits::NotArray<T>
+        [[nodiscard]] detail::SharedProxy<Elem> read_access() const {
+            CB* c = load_ctrl();
+            bool w = load_weak();
+            if (w)  exception::throw_or_abort("read_access: called on weak pointer");
+            if (!c) exception::throw_or_abort("read_access: called on null pointer");
+            return detail::SharedProxy<Elem>(c->get_ptr(), c->get_mutex());
+        }
+
+        /// Copy of a trivially copyable object. In ThreadMode::True it is read
+        /// optimistically, without any lock: the copy is retried while a writer
+        /// holds operator-> or lock_access(), and taken under the shared lock after
+        /// snapshot_retries failed attempts. Writes through operator* or operator[]
+        /// are not seen by the seqlock.
+        template<typename U = T>
+            requires traits::NotArray<U> && std::is_trivially_copyable_v<U>
+        [[nodiscard]] Elem snapshot() const {
+            CB* c = load_ctrl();
+            bool w = load_weak();
+            if (w)  exception::throw_or_abort("snapshot: called on weak pointer");
+            if (!c) exception::throw_or_abort("snapshot: called on null pointer");
+            const Elem* p = c->get_ptr();
+            if constexpr (TM == meta::ThreadMode::True) {
+                std::atomic<std::uint32_t>& seq = c->get_seq();
+                alignas(Elem) unsigned char copy[sizeof(Elem)];
+                for (int attempt = 0; attempt < snapshot_retries; ++attempt) {
+                    const std::uint32_t before = seq.load(std::memory_order_acquire);
+                    if (before & 1) continue;   // writer inside
+                    std::memcpy(copy, static_cast<const void*>(p), sizeof(Elem));
+                    std::atomic_thread_fence(std::memory_order_acquire);
+                    if (seq.load(std::memory_order_relaxed) == before)
+                        return std::bit_cast<Elem>(copy);
+                }
+                std::shared_lock lock(c->get_mutex());
+                return *p;
+            }
+            else {
+                return *p;
+            }
+        }
+
+        static constexpr int snapshot_retries = 64;
+
         // ---- weak pointer support -----------------------------------------------
 
         /// Create a weak handle pointing at the same object as `strong_ref`
@@ -554,11 +1094,8 @@ namespace ptr {
             CB* c = strong_ref.load_ctrl();
             bool w = strong_ref.load_weak();
             if (!c || w) return VSharedPtr();
-            VSharedPtr wp;
-            wp.store_ctrl(c);
-            wp.store_weak(true);
             c->add_weak();
-            return wp;
+            return VSharedPtr(c, true);
         }
 
         /// Promote a weak pointer to a strong one (returns null VSharedPtr on expiry)
@@ -578,12 +1115,10 @@ namespace ptr {
             bool w = other.load_weak();
             if (c && !w) {
                 c->add_weak();
-                store_ctrl(c);
-                store_weak(true);
+                store(c, true);
             }
             else {
-                store_ctrl(nullptr);
-                store_weak(false);
+                handle_ = 0;
             }
         }
 
@@ -604,27 +1139,12 @@ namespace ptr {
         [[nodiscard]] static constexpr meta::ThreadMode thread_mode() noexcept { return TM; }
 
         // ---- mutation -----------------------------------------------------------
-        void reset() noexcept { release(); store_ctrl(nullptr); store_weak(false); }
+        void reset() noexcept { release(); handle_ = 0; }
 
         void reset(Elem* ptr) { VSharedPtr tmp(ptr); swap(tmp); }
 
-        // FIX: swap is inherently non-atomic for two-field types; document and
-        // guard with a note. For truly atomic swap callers must use external sync.
-        void swap(VSharedPtr& other) noexcept {
-            if constexpr (TM == meta::ThreadMode::True) {
-                // Two separate exchanges  not a single atomic op, but consistent
-                // for single-threaded swap callers. Callers requiring atomic swap
-                // must provide their own external synchronization.
-                CB* my_ctrl = exchange_ctrl(other.load_ctrl());
-                bool my_weak = exchange_weak(other.load_weak());
-                other.store_ctrl(my_ctrl);
-                other.store_weak(my_weak);
-            }
-            else {
-                std::swap(ctrl_, other.ctrl_);
-                std::swap(is_weak_, other.is_weak_);
-            }
-        }
+        // Not atomic, as no mutation of a handle is; see AtomicVSharedPtr
+        void swap(VSharedPtr& other) noexcept { std::swap(handle_, other.handle_); }
 
         // ---- comparison ---------------------------------------------------------
         [[nodiscard]] bool operator==(const VSharedPtr& o) const noexcept { return get() == o.get(); }
@@ -634,19 +1154,209 @@ namespace ptr {
         [[nodiscard]] auto operator<=>(const VSharedPtr& o) const noexcept { return get() <=> o.get(); }
     };
 
+    // =============================================================================
+    // AtomicVSharedPtr  lock-free shared slot holding a strong VSharedPtr
+    // =============================================================================
+    // Split reference counting: the slot is one 64-bit word, the control block
+    // in the low 48 bits and a count of readers' claims in the high 16. A
+    // load() claims the block with a single fetch_add on the word, which keeps
+    // it alive, takes a reference of its own, then withdraws the claim. If the
+    // block was replaced meanwhile, whoever replaced it added the claims
+    // outstanding at that moment to the strong count, so the reader drops one
+    // strong reference instead. Nothing locks, and no thread waits on another.
+    template<typename T, meta::ThreadMode TM>
+        requires (TM == meta::ThreadMode::True)
+    class AtomicVSharedPtr {
+    public:
+        using value_type = VSharedPtr<T, TM>;
+
+        static constexpr bool is_always_lock_free = std::atomic<std::uint64_t>::is_always_lock_free;
+
+    private:
+        using CB = typename value_type::CB;
+
+        static_assert(sizeof(void*) == 8, "AtomicVSharedPtr keeps its claim count in the top 16 pointer bits");
+
+        static constexpr unsigned      claim_shift = 48;
+        static constexpr std::uint64_t one_claim   = std::uint64_t{ 1 } << claim_shift;
+        static constexpr std::uint64_t ctrl_mask   = one_claim - 1;
+
+        mutable std::atomic<std::uint64_t> word_{ 0 };
+
+        [[nodiscard]] static CB* ctrl_of(std::uint64_t w) noexcept { return reinterpret_cast<CB*>(w & ctrl_mask); }
+        [[nodiscard]] static std::uint64_t claims_of(std::uint64_t w) noexcept { return w >> claim_shift; }
+
+        [[nodiscard]] static std::uint64_t word_of(CB* c) noexcept {
+            const auto w = static_cast<std::uint64_t>(reinterpret_cast<std::uintptr_t>(c));
+            assert((w & ~ctrl_mask) == 0 && "control block above the 48-bit address range");
+            return w;
+        }
+
+        // The strong reference `v` holds, or one promoted from a weak `v`
+        [[nodiscard]] static CB* adopt(value_type& v) noexcept {
+            if (v.load_weak()) {
+                value_type strong = v.lock();   // try_add_strong: null once expired
+                v.reset();
+                return reinterpret_cast<CB*>(strong.take());
+            }
+            return reinterpret_cast<CB*>(v.take());
+        }
+
+        // Hand the claims outstanding on a replaced word over to its block
+        static void settle(std::uint64_t old) noexcept {
+            if (CB* c = ctrl_of(old); c && claims_of(old) != 0)
+                c->add_strong(static_cast<size_t>(claims_of(old)));
+        }
+
+        void withdraw_claim(CB* c) const noexcept {
+            std::uint64_t cur = word_.load(std::memory_order_relaxed);
+            while (ctrl_of(cur) == c && claims_of(cur) != 0) {
+                if (word_.compare_exchange_weak(cur, cur - one_claim,
+                    std::memory_order_release, std::memory_order_relaxed))
+                    return;
+            }
+            if (c) c->release_strong();   // settled by the store that replaced it
+        }
+
+    public:
+        constexpr AtomicVSharedPtr() noexcept = default;
+        constexpr AtomicVSharedPtr(std::nullptr_t) noexcept {}
+
+        AtomicVSharedPtr(value_type desired) noexcept
+            : word_(word_of(adopt(desired))) {
+        }
+
+        ~AtomicVSharedPtr() {
+            if (CB* c = ctrl_of(word_.load(std::memory_order_acquire))) c->release_strong();
+        }
+
+        AtomicVSharedPtr(const AtomicVSharedPtr&) = delete;
+        AtomicVSharedPtr& operator=(const AtomicVSharedPtr&) = delete;
+
+        void operator=(value_type desired) noexcept { store(std::move(desired)); }
+        [[nodiscard]] operator value_type() const noexcept { return load(); }
+
+        [[nodiscard]] bool is_lock_free() const noexcept { return word_.is_lock_free(); }
+
+        [[nodiscard]] value_type load() const noexcept {
+            const std::uint64_t w = word_.fetch_add(one_claim, std::memory_order_acquire);
+            CB* c = ctrl_of(w);
+            if (c) c->add_strong();   // before withdrawing: the claim keeps it alive until then
+            withdraw_claim(c);
+            return value_type(c, false);
+        }
+
+        void store(value_type desired) noexcept { (void)exchange(std::move(desired)); }
+
+        [[nodiscard]] value_type exchange(value_type desired) noexcept {
+            const std::uint64_t old = word_.exchange(word_of(adopt(desired)), std::memory_order_acq_rel);
+            settle(old);
+            return value_type(ctrl_of(old), false);   // the reference the slot held
+        }
+
+        /// Replace the value with `desired` if it still holds the object `expected`
+        /// holds; otherwise load the current value into `expected`.
+        bool compare_exchange_strong(value_type& expected, value_type desired) noexcept {
+            CB* const e = expected.load_ctrl();
+            CB* const d = adopt(desired);
+            std::uint64_t cur = word_.load(std::memory_order_acquire);
+            while (ctrl_of(cur) == e) {
+                if (word_.compare_exchange_weak(cur, word_of(d),
+                    std::memory_order_acq_rel, std::memory_order_acquire)) {
+                    settle(cur);
+                    value_type(e, false).reset();   // the slot's old reference
+                    return true;
+                }
+            }
+            value_type(d, false).reset();
+            expected = load();
+            return false;
+        }
+
+        bool compare_exchange_weak(value_type& expected, value_type desired) noexcept {
+            return compare_exchange_strong(expected, std::move(desired));
+        }
+    };
+
+    // =============================================================================
+    // Cycle collection
+    // =============================================================================
+    namespace detail {
+
+        template<typename T>
+        struct CycleAccess {
+            // Strong VSharedPtr members of `obj` whose blocks are tracked
+            static void children(T& obj, std::vector<CycleNode*>& out) {
+                std::apply([&](auto... member) {
+                    (edge(obj.*member, out), ...);
+                }, traits::PointerMap<T>::members);
+            }
+
+        private:
+            template<typename U, meta::ThreadMode TM>
+            static void edge(const VSharedPtr<U, TM>& p, std::vector<CycleNode*>& out) {
+                if constexpr (traits::cycle_tracked<std::remove_extent_t<U>, TM>) {
+                    if (auto* c = p.load_ctrl(); c && !p.load_weak())
+                        out.push_back(c);
+                }
+            }
+        };
+
+    } // namespace detail
+
+    /**
+     * @brief Destroy the strong cycles among this thread's tracked objects.
+     *
+     * Tracked are the ThreadMode::False objects whose type specialises
+     * traits::PointerMap. The candidates, blocks whose strong count dropped
+     * without reaching zero, are also collected automatically once
+     * set_cycle_threshold() of them are buffered, and at thread exit.
+     * The destructors of a cycle run in no particular order, so they must not
+     * dereference the other members of their cycle.
+     *
+     * @return the number of objects destroyed
+     */
+    inline size_t collect_cycles() noexcept { return detail::collect_cycles(); }
+
+    /// Buffered candidates that trigger collect_cycles(); 0 turns the automatic runs off
+    inline void set_cycle_threshold(size_t candidates) noexcept { detail::cycle_buffer.threshold = candidates; }
+
+    [[nodiscard]] inline size_t cycle_candidates() noexcept { return detail::cycle_buffer.roots.size(); }
+
     // =============================================================================
     // Factory functions
     // =============================================================================
-    template<typename T, meta::ThreadMode TM = meta::ThreadMode::True, typename... Args>
+    // The control block and the object share one allocation. The object is
+    // destroyed with the last strong reference; its storage is freed with the
+    // block, once the weak references are gone too.
+    template<typename T, meta::ThreadMode TM, typename... Args>
         requires traits::NotArray<T>
     [[nodiscard]] VSharedPtr<T, TM> VMakeShared(Args&&... args) {
-        return VSharedPtr<T, TM>(new T(std::forward<Args>(args)...));
+        using CB = detail::ControlBlock<T, TM>;
+        return VSharedPtr<T, TM>(CB::make_fused(std::forward<Args>(args)...), false);
     }
 
-    template<typename T, meta::ThreadMode TM = meta::ThreadMode::True>
+    template<typename T, meta::ThreadMode TM>
         requires traits::IsUnboundedArray<T>
     [[nodiscard]] VSharedPtr<T, TM> VMakeShared(size_t count) {
-        return VSharedPtr<T, TM>(new std::remove_extent_t<T>[count]());
+        using CB = detail::ControlBlock<std::remove_extent_t<T>, TM>;
+        return VSharedPtr<T, TM>(CB::make_fused_array(count), false);
+    }
+
+    // Default- rather than value-initialized, for storage about to be overwritten:
+    // a trivial T is left as the allocator hands it over
+    template<typename T, meta::ThreadMode TM>
+        requires traits::NotArray<T>
+    [[nodiscard]] VSharedPtr<T, TM> VMakeSharedForOverwrite() {
+        using CB = detail::ControlBlock<T, TM>;
+        return VSharedPtr<T, TM>(CB::make_fused_for_overwrite(), false);
+    }
+
+    template<typename T, meta::ThreadMode TM>
+        requires traits::IsUnboundedArray<T>
+    [[nodiscard]] VSharedPtr<T, TM> VMakeSharedForOverwrite(size_t count) {
+        using CB = detail::ControlBlock<std::remove_extent_t<T>, TM>;
+        return VSharedPtr<T, TM>(CB::template make_fused_array<false>(count), false);
     }
 
     // =============================================================================
@@ -1,8 +1,63 @@
 ﻿#include "gc.h"
 
-#include <algorithm>   // std::stable_partition
+#include <algorithm>   // std::clamp
+#include <bit>         // std::bit_width
+#include <chrono>
+#include <condition_variable>
 #include <cstdlib>     // std::atexit
+#include <cstring>     // std::memset
+#include <exception>   // std::terminate
+#include <limits>
+#include <stdexcept>   // std::length_error
+#include <system_error>
 #include <mutex>
+#include <optional>
+#include <thread>
+
+#if defined(_WIN32)
+#   ifndef WIN32_LEAN_AND_MEAN
+#       define WIN32_LEAN_AND_MEAN
+#   endif
+#   ifndef NOMINMAX
+#       define NOMINMAX
+#   endif
+#   include <windows.h>     // FlushProcessWriteBuffers
+#elif defined(__linux__)
+#   include <linux/membarrier.h>
+#   include <sys/syscall.h>
+#   include <unistd.h>
+#endif
+
+#if defined(__unix__) || defined(__APPLE__)
+#   include <cerrno>
+#   include <csetjmp>
+#   include <pthread.h>
+#   include <signal.h>
+#   define GC_STACK_SCANNING 1
+#   if defined(__linux__)
+#       ifndef GC_SUSPEND_SIGNAL
+#           define GC_SUSPEND_SIGNAL SIGPWR
+#       endif
+#       ifndef GC_RESUME_SIGNAL
+#           define GC_RESUME_SIGNAL SIGXCPU
+#       endif
+#   else
+#       ifndef GC_SUSPEND_SIGNAL
+#           define GC_SUSPEND_SIGNAL SIGXCPU
+#       endif
+#       ifndef GC_RESUME_SIGNAL
+#           define GC_RESUME_SIGNAL SIGXFSZ
+#       endif
+#   endif
+#else
+#   define GC_STACK_SCANNING 0
+#endif
+
+// Entries the mark stack may grow to; a build may lower it to exercise the
+// overflow rescan without a huge heap.
+#ifndef GC_MARK_STACK_LIMIT
+#   define GC_MARK_STACK_LIMIT (std::size_t{ 1 } << 22)
+#endif
 
 
 namespace GC {
@@ -15,8 +70,543 @@ namespace GC {
 
     std::mutex                   gc_mutex;
     thread_local gc_object* current = nullptr;
-    std::vector<gc_object*>      all_objects;
-    std::atomic<long>            gc_counter{ 1024 };
+    thread_local gc_thread* current_thread = nullptr;
+    thread_local gc_heap_state* current_heap = nullptr;
+    std::atomic<long>            gc_counter{ static_cast<long>(heap_config{}.target_heap) };
+    std::atomic<bool>            gc_collecting{ false };
+
+    // Counts the heaps between the start of a collection and the end of its
+    // marking; for the default heap that spans the slices of an incremental
+    // cycle too.  Meanwhile 0 → 1 root transitions and Local<> stores take
+    // the lock of their object's heap; otherwise they are fenced against the
+    // start of marking, the former by the same handshake as allocation, the
+    // latter by the heavy fence that precedes reading the shadow stacks.
+    std::atomic<unsigned>        gc_roots_locked{ 0 };
+    std::atomic<bool>            gc_asymmetric_fences{ false };
+    namespace {
+        bool finalize_object(void* block) noexcept;   ///< the arenas' finalizer; see gc_set_finalizers()
+    }
+
+    gc_arena                     arena{ finalize_object };
+    std::array<const gc_type*, gc_max_types> gc_types{};
+
+    namespace {
+
+        std::mutex          thread_registry_mutex;
+        gc_thread*          thread_registry = nullptr;   ///< every attached gc_thread
+        thread_local bool   thread_detached = false;
+
+        // Stack scanning; see gc_enable_stack_scanning().
+        std::atomic<bool>       stack_scanning{ false };   ///< never cleared once set
+        std::mutex              world_mutex;               ///< held while the world is stopped; attach() waits for it
+        std::atomic<unsigned>   world_epoch{ 0 };          ///< odd while the world is stopped
+        std::atomic<unsigned>   world_acks{ 0 };           ///< threads that reached the suspend handler this time
+        thread_local bool       stopping_world = false;    ///< this thread holds the world stopped, and the registry with it
+
+        // Published objects, guarded by gc_mutex.  The heap itself is found
+        // through the arena's live bitmaps; see gc_collector::enroll().
+        std::vector<gc_object*> incoming;                ///< published, not enrolled yet: never swept
+        std::size_t             enrolled_objects = 0;    ///< enrolled so far, the dead included until swept
+
+        /// Call @p f on every enrolled object.  Caller holds gc_mutex and no sweep is pending.
+        template <typename F>
+        void for_each_enrolled(F&& f)
+        {
+            gc_chunk*   chunk = arena.chunks();
+            std::size_t granule = 0;
+            while (void* block = gc_arena::next_live(chunk, granule))
+                f(static_cast<gc_object*>(block));
+        }
+
+        bool default_roots_locked = false;               ///< the default heap's share of gc_roots_locked, guarded by gc_mutex
+
+        void set_roots_locked(bool locked) noexcept
+        {
+            if (locked == default_roots_locked)
+                return;
+            default_roots_locked = locked;
+            if (locked)
+                gc_roots_locked.fetch_add(1, std::memory_order_relaxed);
+            else
+                gc_roots_locked.fetch_sub(1, std::memory_order_relaxed);
+        }
+
+        // Heap-growth trigger, guarded by gc_mutex.
+        heap_config             heap;
+        std::size_t             live_bytes = 0;          ///< marked bytes at the end of the last full collection
+        long                    heap_budget = static_cast<long>(heap_config{}.target_heap);   ///< gc_counter as last recalibrated
+
+        constexpr long gc_min_budget = 64 * 1024;        ///< never collect more often than this many bytes apart
+
+        /// Bytes to allocate before the next automatic full collection; see gc_set_heap().
+        long growth_budget(const heap_config& config, std::size_t live_size) noexcept
+        {
+            const auto live = static_cast<double>(live_size);
+            double goal = std::max(live * config.growth_factor, static_cast<double>(config.target_heap));
+            if (config.soft_limit != 0)
+                goal = std::min(goal, std::max(static_cast<double>(config.soft_limit), live * 17 / 16));
+            const double budget = std::min(goal - live, static_cast<double>(std::numeric_limits<long>::max() / 2));
+            return std::max(static_cast<long>(budget), gc_min_budget);
+        }
+
+        /// Old-space size (in objects) that forces a full collection in generational mode.
+        std::size_t major_threshold_for(std::size_t old) noexcept
+        {
+            const double threshold = static_cast<double>(old) * std::max(heap.growth_factor, 1.0);
+            return std::max<std::size_t>(static_cast<std::size_t>(threshold), 1024);
+        }
+
+        // Generational mode, guarded by gc_mutex.
+        generational_config     generational;
+        std::vector<gc_object*> nursery;                 ///< enrolled young objects (generational mode only)
+        std::vector<gc_object*> remembered_set;          ///< old objects that point into the nursery
+        std::size_t             old_objects = 0;         ///< old-space size, as of the last full collection plus promotions
+        std::size_t             major_threshold = 1024;  ///< old-space size that forces a full collection
+
+        using gc_clock = std::chrono::steady_clock;
+
+        enum class cycle_phase : std::uint8_t { idle, mark };
+
+        /**
+         * State of an incremental collection, guarded by gc_mutex.
+         *
+         * Outside a cycle and once swept, every mark bit is clear.  During the
+         * mark phase a set bit is grey or black: grey objects sit in `grey`,
+         * black ones have been scanned.  Objects published while a cycle runs
+         * are only enrolled by the next collection, which keeps them out of
+         * this cycle's sweep: in effect they are allocated black.
+         */
+        struct incremental_cycle {
+            cycle_phase             phase{ cycle_phase::idle };
+            std::vector<gc_object*> grey;
+            gc_chunk*               seed_chunk{ nullptr };   ///< where seeding resumes
+            std::size_t             seed_granule{ 0 };
+        };
+
+        incremental_config  incremental;
+        incremental_cycle   cycle;
+
+        // Threads take the locked allocation path for as long as the flag is up.
+        struct collecting_scope {
+            collecting_scope()  noexcept { gc_collecting.store(true, std::memory_order_relaxed); }
+            ~collecting_scope() noexcept { gc_collecting.store(false, std::memory_order_relaxed); }
+        };
+
+        /// The optional collector thread; see start_background_collector().
+        struct background_collector {
+            std::mutex              mutex;
+            std::condition_variable wake;          ///< collector: a collection was requested
+            std::condition_variable done;          ///< mutators: a collection completed
+            std::thread             thread;
+            background_config       config;
+            bool                    running{ false };
+            bool                    stopping{ false };
+            std::uint64_t           completed{ 0 };   ///< collections run so far
+            std::atomic<bool>       active{ false };
+            std::atomic<bool>       requested{ false };
+        };
+
+        background_collector background;
+
+        // Deferred finalization.  The flag is constant-initialized: sweeps may
+        // run before the pool below exists.
+        constexpr std::size_t finalizer_batch = 256;   ///< objects taken off the queue at a time
+        std::atomic<bool>     finalization_deferred{ false };
+
+        /// Queue of dead objects awaiting their destructor, and the threads draining it.
+        struct finalizer_pool {
+            std::mutex              mutex;
+            std::condition_variable wake;      ///< finalizer threads: work was queued, or fewer threads are wanted
+            std::condition_variable retired;   ///< a finalizer thread exited
+            std::condition_variable idle;      ///< no batch is being finalized
+            std::vector<gc_object*> queue;     ///< still allocated, no longer enrolled
+            unsigned                wanted{ 0 };
+            unsigned                running{ 0 };
+            unsigned                busy{ 0 };     ///< threads finalizing a batch
+        };
+
+        // Never destroyed, like the mark pool.
+        finalizer_pool& finalizers = *new finalizer_pool;
+
+        constexpr std::size_t mark_stack_limit = GC_MARK_STACK_LIMIT;   ///< entries; a deeper trace rescans instead
+        static_assert(mark_stack_limit >= 1024, "GC_MARK_STACK_LIMIT must be at least 1024");
+
+        /**
+         * Mark stack kept from one trace to the next, so that marking only
+         * allocates while the stack grows towards its high-water mark.  It
+         * stops growing at mark_stack_limit, or when memory runs out: a push
+         * is then dropped and `overflowed` set, and the trace starts over
+         * from the marked objects that still have unmarked children.
+         */
+        struct mark_stack {
+            std::vector<gc_object*> items;
+            bool                    overflowed{ false };
+
+            [[nodiscard]] bool empty() const noexcept { return items.empty(); }
+            [[nodiscard]] std::size_t size() const noexcept { return items.size(); }
+
+            void push(gc_object* o) noexcept
+            {
+                if (items.size() == items.capacity() && !grow()) {
+                    overflowed = true;
+                    return;
+                }
+                items.push_back(o);
+            }
+
+            gc_object* pop() noexcept
+            {
+                gc_object* o = items.back();
+                items.pop_back();
+                return o;
+            }
+
+            /**
+             * Stop growing until thaw(), with room for @p hint entries if that
+             * much can be had now: the world is stopped meanwhile, and a
+             * suspended thread may hold the allocator's lock.
+             */
+            void freeze(std::size_t hint) noexcept
+            {
+                try {
+                    items.reserve(std::clamp<std::size_t>(hint, 1024, mark_stack_limit));
+                }
+                catch (const std::bad_alloc&) {
+                }
+                frozen_ = items.capacity() != 0;   // else a push could never succeed
+            }
+
+            void thaw() noexcept { frozen_ = false; }
+
+            [[nodiscard]] bool frozen() const noexcept { return frozen_; }
+
+        private:
+            bool frozen_{ false };
+
+            bool grow() noexcept
+            {
+                if (frozen_ || items.capacity() >= mark_stack_limit)
+                    return false;
+                try {
+                    items.reserve(std::clamp<std::size_t>(items.capacity() * 2, 1024, mark_stack_limit));
+                    return true;
+                }
+                catch (const std::bad_alloc&) {
+                    return false;
+                }
+            }
+        };
+
+        // Parallel marking.
+        constexpr std::size_t parallel_mark_min = 16 * 1024;   ///< smaller heaps are traced serially
+        constexpr std::size_t mark_share_size   = 256;         ///< private stack depth that triggers sharing
+
+        /// Shared half of one marker's work; the owner refills from it, thieves take from the front.
+        struct mark_deque {
+            std::mutex               mutex;
+            std::vector<gc_object*>  items;        ///< keeps its capacity from one trace to the next
+            std::atomic<std::size_t> size{ 0 };   ///< items.size(), readable without the lock
+        };
+
+        /// One parallel trace, worked on by the collecting thread and the helpers.
+        struct mark_job {
+            explicit mark_job(unsigned n) : deques(n) {}
+
+            /// Ready for another trace; the deques were left empty by the last one.
+            void reset(bool young) noexcept
+            {
+                idle.store(0, std::memory_order_relaxed);
+                done.store(false, std::memory_order_relaxed);
+                overflowed.store(false, std::memory_order_relaxed);
+                young_only = young;
+            }
+
+            std::vector<mark_deque> deques;
+            std::atomic<unsigned>   idle{ 0 };      ///< markers out of work
+            std::atomic<bool>       done{ false };
+            std::atomic<bool>       overflowed{ false };   ///< a marker dropped a push
+            bool                    young_only{ false };
+        };
+
+        /// Helper threads, started on first use and parked between traces.
+        struct mark_pool {
+            std::mutex              mutex;
+            std::condition_variable wake;         ///< helpers: a new job was posted
+            std::condition_variable finished;     ///< collector: every helper left the job
+            std::atomic<unsigned>   workers{ 1 };  ///< markers per trace, collecting thread included
+            unsigned                started{ 0 };
+            unsigned                busy{ 0 };     ///< helpers still inside the current job
+            std::uint64_t           generation{ 0 };
+            mark_job*               job{ nullptr };
+        };
+
+        // Helpers are detached and the pool is never destroyed, so collections
+        // that run during static destruction still find it intact.
+        mark_pool& markers = *new mark_pool;
+
+        /// What a collection of the default heap works in, kept for the next one.
+        struct collector_buffers {
+            mark_stack                marking;   ///< guarded by gc_mutex
+            std::unique_ptr<mark_job> job;       ///< the last parallel trace, guarded by gc_mutex
+
+            std::mutex              garbage_mutex;
+            std::vector<gc_object*> garbage;     ///< empty, or taken by a collection in progress
+        };
+
+        // Never destroyed either.
+        collector_buffers& buffers = *new collector_buffers;
+
+        /**
+         * The garbage list of one collection, destructors included.  Its
+         * capacity is handed on to the next collection; one that overlaps,
+         * from a destructor or another thread, starts from an empty list.
+         */
+        struct garbage_list {
+            garbage_list() noexcept
+            {
+                std::scoped_lock lock{ buffers.garbage_mutex };
+                items.swap(buffers.garbage);
+            }
+
+            ~garbage_list()
+            {
+                items.clear();
+                std::scoped_lock lock{ buffers.garbage_mutex };
+                if (items.capacity() > buffers.garbage.capacity())
+                    items.swap(buffers.garbage);
+            }
+
+            garbage_list(const garbage_list&) = delete;
+            garbage_list& operator=(const garbage_list&) = delete;
+
+            std::vector<gc_object*> items;
+        };
+
+        // Statistics.  Allocation counters of exited threads, and of threads
+        // without a gc_thread, are folded in here.
+        struct retired_counters {
+            std::atomic<std::uint64_t> allocated_objects{ 0 };
+            std::atomic<std::uint64_t> allocated_bytes{ 0 };
+            std::atomic<std::uint64_t> root_slow_paths{ 0 };
+        };
+
+        struct collector_stats {
+            std::mutex                                          mutex;
+            heap_stats                                          totals;         ///< collection fields only
+            std::array<collection_record, gc_history_length>    history{};      ///< ring buffer
+            std::size_t                                         recorded{ 0 };  ///< records ever added
+        };
+
+        retired_counters    retired;
+        collector_stats     stats;
+        collection_record   current_record;              ///< collection in progress, guarded by gc_mutex
+
+        std::mutex                                  callbacks_mutex;
+        std::shared_ptr<const collection_callbacks> callbacks;   ///< null when none are installed
+        std::atomic<bool>                           callbacks_installed{ false };
+        thread_local bool                           in_callback = false;
+
+    } // anonymous namespace
+
+    // ─────────────────────────────────────────────────────────────────────────────
+    // gc_collector
+    // ─────────────────────────────────────────────────────────────────────────────
+
+    /// Collector internals; a friend of gc_object, gc_base_ptr and gc_thread.
+    class gc_collector {
+    public:
+        enum class kind { automatic, minor, full };
+
+        static void collect(kind k);
+        static std::size_t compact(double occupancy);
+        static bool step(std::chrono::microseconds budget);
+        static void set_generational(const generational_config& config);
+        static void set_incremental(const incremental_config& config);
+        static void set_heap(const heap_config& config);
+
+        static void start_background(const background_config& config);
+        static void stop_background();
+
+        static void set_finalizers(const finalizer_config& config);
+        static std::size_t run_finalizers(std::chrono::microseconds budget);
+
+        static void* allocate_untyped(std::size_t bytes, bool zeroed);
+        static bool free_untyped(void* p) noexcept;
+        static bool enable_stack_scanning();
+        static void register_thread();
+        static void drain_finalizers() noexcept;
+        [[nodiscard]] static bool defer(gc_object* o) noexcept;
+
+        [[nodiscard]] static heap_stats read_stats();
+        static void set_callbacks(collection_callbacks callbacks);
+        static void note_root_slow_path() noexcept;
+
+        static void collect_heap(gc_heap_state& h);
+        static void destroy_heap(gc_heap_state& h) noexcept;
+        static void set_heap_config(gc_heap_state& h, const heap_config& config);
+        [[nodiscard]] static bool region_escaped(gc_heap_state& h) noexcept;
+        /// 0 → 1 root transition without gc_mutex; false if the collector is reading root counts.
+        [[nodiscard]] static bool try_first_root(gc_object* o) noexcept;
+        /// Hand an automatic collection to the collector thread; false if there is none.
+        static bool request_background(long counter);
+
+        /// Old-to-young store barrier.  Caller holds gc_mutex.
+        static void remember(gc_object* owner, gc_object* target);
+        /// As remember(), with the owner looked up from the address of the slot.
+        static void remember_store(const gc_base_ptr* slot, gc_object* target);
+
+        /// Hand objects over to the collector.  Caller holds gc_mutex.
+        static void admit(std::span<gc_object* const> objects)
+        {
+            incoming.insert(incoming.end(), objects.begin(), objects.end());
+        }
+
+        /// Call @p f on every object @p o points at, through its pointer map or its list.
+        template <typename F>
+        static void for_each_child(gc_object* o, F&& f)
+        {
+            atomic_thread_fence(std::memory_order_acquire);
+            // Pointers into other heaps are not followed.
+            const gc_arena* const home = gc_arena::chunk_of(o)->arena;
+            auto visit = [&](gc_object* c) {
+                if (gc_arena::chunk_of(c)->arena == home)
+                    f(c);
+            };
+            // A linked Ptr implies an unmapped type, so list objects never touch the descriptor.
+            if (gc_base_ptr* j = o->first.load(std::memory_order_relaxed)) {
+                do {
+                    if (gc_object* c = j->object.load(std::memory_order_relaxed))
+                        visit(c);
+                    j = j->next.load(std::memory_order_relaxed);
+                } while (j != nullptr);
+                return;
+            }
+            const gc_type& t = *gc_types[o->type];
+            if (t.conservative) {
+                // Any word naming a live block of this heap, at its start or inside it
+                const auto* word = static_cast<const std::uintptr_t*>(o->start());
+                for (std::size_t i = o->count() / sizeof(std::uintptr_t); i != 0; --i, ++word) {
+                    void* b = home->block_of(reinterpret_cast<const void*>(*word));
+                    if (b != nullptr && b != o && gc_live(b))
+                        f(static_cast<gc_object*>(b));
+                }
+                return;
+            }
+            if (!t.mapped)
+                return;
+            const std::size_t* const offsets = t.pointers.data();
+            const std::size_t fields = t.pointers.size();
+            auto* element = static_cast<char*>(o->start());
+            const std::size_t n = o->count();
+            for (std::size_t i = 0; i != n; ++i, element += t.size) {
+                for (std::size_t k = 0; k != fields; ++k) {
+                    auto* p = reinterpret_cast<gc_base_ptr*>(element + offsets[k]);
+                    if (gc_object* c = p->object.load(std::memory_order_relaxed))
+                        visit(c);
+                }
+            }
+        }
+
+        [[nodiscard]] static bool in_default_heap(const gc_object* o) noexcept
+        {
+            return gc_arena::chunk_of(o)->arena == &arena;
+        }
+
+        /// The lock of @p o's heap.
+        [[nodiscard]] static std::mutex& heap_mutex(const gc_object* o) noexcept;
+
+        /// Held around a heap store of @p o, so that it waits for marking to end.
+        [[nodiscard]] static std::unique_lock<std::mutex> barrier_lock(const gc_object* o);
+
+        /// Tri-color barrier: grey @p o while an incremental mark is running.  Caller holds gc_mutex.
+        static void shade(gc_object* o)
+        {
+            if (in_default_heap(o) && cycle.phase == cycle_phase::mark && !o->marked()) {
+                o->set_marked(true);
+                cycle.grey.push_back(o);
+            }
+        }
+
+        /// The stop a gc_deferring_lock section held back; see gc_suspend_deferred().
+        static void suspend_deferred() noexcept;
+
+    private:
+        /**
+         * While it lives, with stack scanning on, every other registered
+         * thread stands still in the suspend handler, and each block the
+         * stacks name is marked; old blocks are skipped if @p young_only.
+         * Caller holds gc_mutex.
+         *
+         * The thread registry stays locked throughout.  Nothing else may be
+         * locked or allocated meanwhile that a suspended thread could hold:
+         * @p marking, if given, is sized for @p objects and then kept from
+         * growing, and it is traced on this thread alone.
+         */
+        class stopped_world {
+        public:
+            explicit stopped_world(bool young_only, mark_stack* marking = nullptr, std::size_t objects = 0);
+            ~stopped_world();
+
+            stopped_world(const stopped_world&) = delete;
+            stopped_world& operator=(const stopped_world&) = delete;
+
+        private:
+            std::unique_lock<std::mutex> lock_;       ///< world_mutex; empty if nothing was stopped
+            std::unique_lock<std::mutex> registry_;   ///< thread_registry_mutex, until the resume
+            mark_stack*                  marking_;
+        };
+
+        static void suspended() noexcept;
+        static void stand_still(const char* top) noexcept;
+        static void mark_stacks(bool young_only);
+
+        static void switch_generational(const generational_config& config);
+        static void background_main();
+
+        [[nodiscard]] static std::unique_lock<std::mutex> lock_swept();
+        [[nodiscard]] static std::unique_lock<std::mutex> lock_swept(gc_heap_state& h);
+        static void wait_for_root_steps();
+        static void enroll(gc_heap_state& h) noexcept;
+        static void publish_young();
+        static void enroll();
+        static void full(std::vector<gc_object*>& garbage);
+        static void minor(std::vector<gc_object*>& garbage);
+
+        static void reseed(gc_object* c, mark_stack& pending, bool young_only);
+        static void seed(std::vector<gc_object*>& space, mark_stack& pending);
+        static void seed_heap(mark_stack& pending);
+        template <typename F>
+        static void for_each_local(const gc_arena& space, F&& f);
+        static void trace(mark_stack& pending, bool young_only);
+        static void drain(mark_stack& pending, bool young_only);
+        static void trace_parallel(mark_stack& pending, bool young_only, unsigned workers);
+        static void mark_worker(mark_job& job, unsigned id, mark_stack& stack);
+        static bool mark_refill(mark_job& job, unsigned id, mark_stack& stack);
+        static void mark_helper_main(unsigned id);
+        static void sweep(std::vector<gc_object*>& space, std::vector<gc_object*>& garbage);
+        static void promote();
+        static void destroy(std::vector<gc_object*>& garbage) noexcept;
+
+        [[nodiscard]] static std::shared_ptr<const collection_callbacks> begin_callbacks();
+        static void close_record(collection_record& record, const std::vector<gc_object*>& garbage,
+                                 gc_clock::time_point locked);
+        static void end_collection(collection_record& record, gc_clock::time_point destroy_start,
+                                   const std::shared_ptr<const collection_callbacks>& hooks);
+
+        static void begin_cycle();
+        static bool advance(gc_clock::time_point deadline, std::vector<gc_object*>& garbage);
+        static void finish_cycle(std::vector<gc_object*>& garbage);
+        static void abandon_cycle();
+
+        static void finish_finalizers();
+        [[nodiscard]] static gc_object* forwarded(gc_object* o) noexcept;
+        static void relocate(gc_base_ptr& p) noexcept;
+        static void move(gc_object* from, std::size_t size);
+        template <typename F>
+        static void for_each_slot(gc_object* o, F&& f);
+
+        [[nodiscard]] static bool has_young_child(gc_object* o) noexcept;
+    };
 
     // ─────────────────────────────────────────────────────────────────────────────
     // Automatic collection at program exit
@@ -26,7 +616,9 @@ namespace GC {
 
         void gc_atexit_handler() noexcept
         {
+            stop_background_collector();
             gc_collect();
+            gc_collector::drain_finalizers();
         }
 
         // Self-registering struct: its constructor runs before main() and installs
@@ -35,332 +627,2534 @@ namespace GC {
             GcAtExitRegistrar() noexcept { std::atexit(gc_atexit_handler); }
         } const gc_atexit_registrar;
 
-    } // anonymous namespace
+    } // anonymous namespace
+
+    // ─────────────────────────────────────────────────────────────────────────────
+    // Asymmetric fences
+    // ─────────────────────────────────────────────────────────────────────────────
+
+    namespace {
+
+        bool enable_asymmetric_fences() noexcept
+        {
+#if defined(_WIN32)
+            return true;
+#elif defined(__linux__) && defined(SYS_membarrier)
+            const long cmds = syscall(SYS_membarrier, MEMBARRIER_CMD_QUERY, 0, 0);
+            if (cmds < 0 || (cmds & MEMBARRIER_CMD_PRIVATE_EXPEDITED) == 0)
+                return false;
+            return syscall(SYS_membarrier, MEMBARRIER_CMD_REGISTER_PRIVATE_EXPEDITED, 0, 0) == 0;
+#else
+            return false;
+#endif
+        }
+
+    } // anonymous namespace
+
+    void gc_heavy_fence() noexcept
+    {
+        if (!gc_asymmetric_fences.load(std::memory_order_relaxed)) {
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            return;
+        }
+#if defined(_WIN32)
+        FlushProcessWriteBuffers();
+#elif defined(__linux__) && defined(SYS_membarrier)
+        syscall(SYS_membarrier, MEMBARRIER_CMD_PRIVATE_EXPEDITED, 0, 0);
+#endif
+    }
+
+    // ─────────────────────────────────────────────────────────────────────────────
+    // gc_thread
+    // ─────────────────────────────────────────────────────────────────────────────
+
+    // Detaches the thread's gc_thread record when the thread exits.
+    struct gc_thread_exit {
+        ~gc_thread_exit() { gc_thread::detach(); }
+    };
+
+#if GC_STACK_SCANNING
+    struct gc_thread::stack_range {
+        pthread_t                handle;
+        const char*              base;                  ///< one past the oldest frame
+        std::atomic<const char*> top{ nullptr };        ///< saved by the suspend handler; null if it has not run
+    };
+
+    namespace {
+
+        /// One past the highest address of the calling thread's stack.
+        const char* stack_base() noexcept
+        {
+#   if defined(__APPLE__)
+            return static_cast<const char*>(pthread_get_stackaddr_np(pthread_self()));
+#   else
+#       if defined(__linux__)
+            pthread_attr_t attr;
+            if (pthread_getattr_np(pthread_self(), &attr) == 0) {
+                void*       low  = nullptr;
+                std::size_t size = 0;
+                const bool  ok   = pthread_attr_getstack(&attr, &low, &size) == 0;
+                pthread_attr_destroy(&attr);
+                if (ok)
+                    return static_cast<const char*>(low) + size;
+            }
+#       endif
+            // Unknown: the frames of the caller and above are all that is scanned.
+            return static_cast<const char*>(__builtin_frame_address(0));
+#   endif
+        }
+
+    } // anonymous namespace
+#endif
+
+    gc_thread* gc_thread::attach()
+    {
+        if (thread_detached)
+            return nullptr;
+
+        // Decided once, before any thread relies on gc_light_fence() being cheap.
+        static const bool fences_decided = [] {
+            gc_asymmetric_fences.store(enable_asymmetric_fences(), std::memory_order_relaxed);
+            return true;
+        }();
+        (void)fences_decided;
+
+        auto* t = new gc_thread;
+#if GC_STACK_SCANNING
+        try {
+            t->stack_ = new stack_range{ pthread_self(), stack_base() };
+        }
+        catch (...) {
+            delete t;
+            throw;
+        }
+#endif
+        // Set first: the suspend handler finds the thread's stack range here.
+        current_thread = t;
+        {
+            std::scoped_lock lock{ world_mutex, thread_registry_mutex };
+            t->next_ = thread_registry;
+            thread_registry = t;
+        }
+
+        static thread_local gc_thread_exit exit_hook;
+        (void)exit_hook;
+        return t;
+    }
+
+    void gc_thread::detach() noexcept
+    {
+        gc_thread* t = current_thread;
+        current_thread = nullptr;
+        thread_detached = true;
+        if (t == nullptr)
+            return;
+
+        {
+            // Holding gc_mutex keeps the collector away from the registry and
+            // from the published objects while the young list is handed over.
+            std::scoped_lock lock{ gc_mutex, thread_registry_mutex };
+            gc_collector::admit(t->young_);
+
+            gc_thread** link = &thread_registry;
+            while (*link != t)
+                link = &(*link)->next_;
+            *link = t->next_;
+
+            retired.allocated_objects.fetch_add(t->counters_.allocated_objects.load(std::memory_order_relaxed), std::memory_order_relaxed);
+            retired.allocated_bytes.fetch_add(t->counters_.allocated_bytes.load(std::memory_order_relaxed), std::memory_order_relaxed);
+            retired.root_slow_paths.fetch_add(t->counters_.root_slow_paths.load(std::memory_order_relaxed), std::memory_order_relaxed);
+        }
+        delete t->stack_;
+        delete t;   // ~gc_cell_cache returns the cached cells to the arena
+    }
+
+    void gc_thread::settle(gc_thread* t, long bytes)
+    {
+        // Large allocations are charged in full at once, so that they count
+        // towards the trigger before the memory is handed out.
+        const long spent = t ? std::max(bytes, credit_batch) : bytes;
+        if (t)
+            t->credits_ = spent - bytes;
+
+        const long counter = gc_counter.fetch_sub(spent, std::memory_order_relaxed);
+        if (counter <= 0 && !gc_collector::request_background(counter))
+            gc_collector::collect(gc_collector::kind::automatic);
+    }
+
+    void gc_thread::count_detached(std::size_t bytes) noexcept
+    {
+        retired.allocated_objects.fetch_add(1, std::memory_order_relaxed);
+        retired.allocated_bytes.fetch_add(bytes, std::memory_order_relaxed);
+    }
+
+    std::atomic<gc_object*>* gc_thread::push_local() noexcept
+    {
+        try {
+            gc_thread* t = current_thread ? current_thread : attach();
+            return t ? t->locals_.push() : nullptr;
+        }
+        catch (const std::bad_alloc&) {
+            return nullptr;
+        }
+    }
+
+    void gc_thread::local_barrier_slow(gc_object* o) noexcept
+    {
+        gc_collector::note_root_slow_path();
+        std::scoped_lock lock{ gc_collector::heap_mutex(o) };
+        gc_collector::shade(o);
+    }
+
+    gc_object* gc_thread::allocate_locked(void* mem, std::uint16_t type, std::size_t count, bool root)
+    {
+        std::scoped_lock lock{ gc_mutex };
+
+        try {
+            incoming.reserve(incoming.size() + 1);
+        }
+        catch (...) {
+            arena.deallocate(mem);
+            throw;
+        }
+
+        auto* o = ::new (mem) gc_object(type, count);
+        if (root)
+            o->root_ref_cnt.store(1, std::memory_order_relaxed);
+        incoming.push_back(o);
+        return o;
+    }
+
+    void gc_thread::allocate_batch(std::size_t bytes, std::uint16_t type, std::span<gc_object*> out)
+    {
+        // Registered up front, so that abandon_batch() cannot throw.
+        static_cast<void>(gc_type_index<std::byte>());
+
+        if (current_heap != nullptr) {
+            std::size_t i = 0;
+            try {
+                for (; i != out.size(); ++i)
+                    out[i] = allocate_in(current_heap, bytes, type, gc_object::npos, true);
+            }
+            catch (...) {
+                abandon_batch(out.first(i));
+                throw;
+            }
+            return;
+        }
+
+        const std::size_t total = bytes * out.size();
+        gc_thread* t = current_thread ? current_thread : attach();
+        charge(t, total);
+        if (t != nullptr) {
+            bump(t->counters_.allocated_objects, out.size());
+            bump(t->counters_.allocated_bytes, total);
+        }
+        else {
+            count_detached(total);
+        }
+
+        // The cells first, as in allocate(): sweeping may run destructors.
+        std::size_t got = 0;
+        try {
+            if (bytes > gc_max_small_size) {
+                for (; got != out.size(); ++got)
+                    out[got] = static_cast<gc_object*>(t ? t->cells_.allocate(bytes) : arena.allocate(bytes));
+            }
+            else {
+                const std::size_t cls = gc_size_class(bytes);
+                while (got != out.size()) {
+                    if (arena.sweep_pending())
+                        arena.sweep(cls);
+                    for (gc_free_cell* c = arena.take(cls, out.size() - got); c != nullptr; c = c->next)
+                        out[got++] = reinterpret_cast<gc_object*>(c);
+                }
+            }
+        }
+        catch (...) {
+            arena.deallocate(std::span<gc_object* const>(out.first(got)));
+            throw;
+        }
+
+        auto construct = [&](std::vector<gc_object*>& list) {
+            for (gc_object*& o : out) {
+                o = ::new (static_cast<void*>(o)) gc_object(type, gc_object::npos);
+                o->root_ref_cnt.store(1, std::memory_order_relaxed);
+                list.push_back(o);
+            }
+        };
+
+        if (t == nullptr || !t->enter()) {
+            std::scoped_lock lock{ gc_mutex };
+            try {
+                incoming.reserve(incoming.size() + out.size());
+            }
+            catch (...) {
+                arena.deallocate(std::span<gc_object* const>(out));
+                throw;
+            }
+            construct(incoming);
+            return;
+        }
+
+        struct leave_guard {
+            gc_thread* t;
+            ~leave_guard() { t->leave(); }
+        } guard{ t };
+
+        try {
+            t->young_.reserve(t->young_.size() + out.size());
+        }
+        catch (...) {
+            arena.deallocate(std::span<gc_object* const>(out));
+            throw;
+        }
+        construct(t->young_);
+    }
+
+    // Retyped as trivial under the lock of their heap, which every collector
+    // holds while it reads the types of registered objects.
+    void gc_thread::abandon_batch(std::span<gc_object* const> objects) noexcept
+    {
+        const std::uint16_t blank = gc_type_index<std::byte>();
+        for (gc_object* o : objects) {
+            std::scoped_lock lock{ gc_collector::heap_mutex(o) };
+            o->type = blank;
+            o->first.store(nullptr, std::memory_order_relaxed);
+            o->root_ref_cnt.store(0, std::memory_order_relaxed);
+        }
+    }
+
+    // ─────────────────────────────────────────────────────────────────────────────
+    // gc_object
+    // ─────────────────────────────────────────────────────────────────────────────
+
+    gc_object::gc_object(std::uint16_t t, std::size_t n) noexcept
+        : type(t)
+        , array(n != npos)
+    {
+        root_ref_cnt.store(0, std::memory_order_relaxed);
+        first.store(nullptr, std::memory_order_relaxed);
+        if (array)
+            *reinterpret_cast<std::size_t*>(this + 1) = n;
+
+        // The collector may scan a mapped object before its constructor has
+        // run: start every Ptr<> slot out null, as a large block already is.
+        if (const gc_type& d = *gc_types[t]; d.mapped && !gc_large_block(overhead(array) + count() * d.size)) {
+            auto* element = static_cast<char*>(start());
+            for (std::size_t i = count(); i != 0; --i, element += d.size) {
+                for (std::size_t offset : d.pointers)
+                    std::memset(element + offset, 0, sizeof(gc_base_ptr));
+            }
+        }
+    }
+
+    gc_object::~gc_object()
+    {
+        if (auto destroy = gc_types[type]->destroy)
+            destroy(static_cast<std::byte*>(start()), static_cast<std::byte*>(end()));
+    }
+
+    // ─────────────────────────────────────────────────────────────────────────────
+    // Type descriptors
+    // ─────────────────────────────────────────────────────────────────────────────
+
+    std::uint16_t gc_register_type(const gc_type& type)
+    {
+        static std::mutex  mutex;
+        static std::size_t used = 0;
+
+        std::scoped_lock lock{ mutex };
+        if (used == gc_max_types)
+            throw std::length_error("GC: too many managed types");
+        gc_types[used] = &type;
+        return static_cast<std::uint16_t>(used++);
+    }
+
+    // ─────────────────────────────────────────────────────────────────────────────
+    // Untyped blocks
+    // ─────────────────────────────────────────────────────────────────────────────
+
+    namespace {
+
+        /// An array of bytes, so the cookie holds the size; never destroyed, never moved.
+        constexpr gc_type untyped_type{ .destroy = nullptr, .size = 1, .pinned = true, .conservative = true };
+
+        [[nodiscard]] std::uint16_t untyped_index()
+        {
+            static const std::uint16_t index = gc_register_type(untyped_type);
+            return index;
+        }
+
+    } // anonymous namespace
+
+    void* gc_collector::allocate_untyped(std::size_t bytes, bool zeroed)
+    {
+        constexpr std::size_t header = gc_object::overhead(true);
+        if (bytes > std::numeric_limits<std::size_t>::max() - header)
+            throw std::bad_alloc();
+
+        // Stack scanning finds the C pointers to it instead.
+        const bool root = !stack_scanning.load(std::memory_order_acquire);
+        gc_object* o = gc_thread::allocate(header + bytes, untyped_index(), bytes, root);
+        void* p = o->start();
+        // A large span is freshly mapped; only a recycled cell can be dirty.
+        if (zeroed && !gc_large_block(header + bytes))
+            std::memset(p, 0, bytes);
+        return p;
+    }
+
+    bool gc_collector::free_untyped(void* p) noexcept
+    {
+        if (p == nullptr)
+            return true;
+        const gc_arena* space = gc_arena::owner_of(p);
+        auto* o = static_cast<gc_object*>(space ? space->block_of(p) : nullptr);
+        if (o == nullptr || p != reinterpret_cast<char*>(o) + gc_object::overhead(true) || o->type != untyped_index())
+            return false;
+
+        int cnt = o->root_ref_cnt.load(std::memory_order_relaxed);
+        while (cnt > 0 && !o->root_ref_cnt.compare_exchange_weak(cnt, cnt - 1, std::memory_order_relaxed)) {
+        }
+        return cnt > 0;
+    }
+
+    // ─────────────────────────────────────────────────────────────────────────────
+    // Stack scanning
+    // ─────────────────────────────────────────────────────────────────────────────
+
+#if GC_STACK_SCANNING
+    namespace {
+
+        /// Call @p f on every block of the default heap named by an aligned word of [lo, hi).
+        template <typename F>
+        __attribute__((no_sanitize("address", "thread")))
+        void for_each_stack_root(const char* lo, const char* hi, F&& f)
+        {
+            constexpr std::uintptr_t align = alignof(std::uintptr_t);
+            auto at = (reinterpret_cast<std::uintptr_t>(lo) + align - 1) & ~(align - 1);
+            for (; at + sizeof(std::uintptr_t) <= reinterpret_cast<std::uintptr_t>(hi); at += sizeof(std::uintptr_t)) {
+                const std::uintptr_t word = *reinterpret_cast<const std::uintptr_t*>(at);
+                void* b = arena.block_of(reinterpret_cast<const void*>(word));
+                if (b != nullptr && gc_live(b))
+                    f(static_cast<gc_object*>(b));
+            }
+        }
+
+        /// As for_each_stack_root(), for the calling thread from the frame of this call up to @p base.
+        template <typename F>
+        [[gnu::noinline]] void for_each_own_root(const char* base, F&& f)
+        {
+            // Spill the callee-saved registers into this frame.
+            std::jmp_buf registers;
+            (void)setjmp(registers);
+            for_each_stack_root(reinterpret_cast<const char*>(&registers), base, f);
+            std::atomic_signal_fence(std::memory_order_seq_cst);   // keeps `registers` alive to here
+        }
+
+    } // anonymous namespace
+#endif
+
+    bool gc_collector::enable_stack_scanning()
+    {
+#if GC_STACK_SCANNING
+        static const bool installed = [] {
+            struct sigaction suspend{};
+            suspend.sa_handler = [](int) { suspended(); };
+            suspend.sa_flags = SA_RESTART;
+            sigemptyset(&suspend.sa_mask);
+            sigaddset(&suspend.sa_mask, GC_RESUME_SIGNAL);   // held back until sigsuspend()
+
+            struct sigaction resume{};
+            resume.sa_handler = [](int) {};
+            resume.sa_flags = SA_RESTART;
+            sigemptyset(&resume.sa_mask);
+
+            return sigaction(GC_RESUME_SIGNAL, &resume, nullptr) == 0 &&
+                   sigaction(GC_SUSPEND_SIGNAL, &suspend, nullptr) == 0;
+        }();
+        if (!installed)
+            return false;
+
+        register_thread();
+        std::unique_lock lock = lock_swept();
+        // Its grey and black objects were found without the stacks.
+        if (cycle.phase != cycle_phase::idle)
+            abandon_cycle();
+        stack_scanning.store(true, std::memory_order_release);
+        return true;
+#else
+        return false;
+#endif
+    }
+
+    void gc_collector::register_thread()
+    {
+        if (current_thread == nullptr)
+            (void)gc_thread::attach();
+    }
+
+    // The suspend handler.  Inside a gc_deferring_lock section it only leaves
+    // a note for the end of the section.  Only async-signal-safe calls and
+    // lock-free atomics.
+    void gc_collector::suspended() noexcept
+    {
+#if GC_STACK_SCANNING
+        if (gc_suspend.depth.load(std::memory_order_relaxed) != 0) {
+            gc_suspend.pending.store(true, std::memory_order_relaxed);
+            return;
+        }
+        const int saved_errno = errno;
+        // The interrupted registers were saved by the kernel, above this frame.
+        const char here = 0;
+        stand_still(&here);
+        errno = saved_errno;
+#endif
+    }
+
+    // The same, at the end of the section the signal landed in.  The resume
+    // signal is held back until sigsuspend(), as it is in the handler.
+    [[gnu::noinline]] void gc_collector::suspend_deferred() noexcept
+    {
+#if GC_STACK_SCANNING
+        gc_suspend.pending.store(false, std::memory_order_relaxed);
+        sigset_t resume;
+        sigset_t saved;
+        sigemptyset(&resume);
+        sigaddset(&resume, GC_RESUME_SIGNAL);
+        pthread_sigmask(SIG_BLOCK, &resume, &saved);
+
+        // Spill the callee-saved registers into this frame.
+        std::jmp_buf registers;
+        (void)setjmp(registers);
+        stand_still(reinterpret_cast<const char*>(&registers));
+        std::atomic_signal_fence(std::memory_order_seq_cst);   // keeps `registers` alive to here
+
+        pthread_sigmask(SIG_SETMASK, &saved, nullptr);
+#endif
+    }
+
+    // Leave the stack top where the collector finds it, then wait for the
+    // resume signal of this same stop.
+    void gc_collector::stand_still(const char* top) noexcept
+    {
+#if GC_STACK_SCANNING
+        const unsigned epoch = world_epoch.load(std::memory_order_acquire);
+        if (gc_thread* t = current_thread; t != nullptr && t->stack_ != nullptr)
+            t->stack_->top.store(top, std::memory_order_relaxed);
+        world_acks.fetch_add(1, std::memory_order_release);
+
+        sigset_t waiting;
+        pthread_sigmask(SIG_BLOCK, nullptr, &waiting);
+        sigdelset(&waiting, GC_RESUME_SIGNAL);
+        while (world_epoch.load(std::memory_order_acquire) == epoch)
+            sigsuspend(&waiting);
+#else
+        (void)top;
+#endif
+    }
+
+    void gc_suspend_deferred() noexcept
+    {
+        gc_collector::suspend_deferred();
+    }
+
+    gc_collector::stopped_world::stopped_world(bool young_only, mark_stack* marking, std::size_t objects)
+        : marking_(nullptr)
+    {
+#if GC_STACK_SCANNING
+        if (!stack_scanning.load(std::memory_order_acquire))
+            return;
+        if (marking != nullptr) {
+            marking->freeze(objects / 8);
+            marking_ = marking;
+        }
+        lock_ = std::unique_lock{ world_mutex };
+        // Whoever held it has let go, so nobody is stopped inside the registry.
+        registry_ = std::unique_lock{ thread_registry_mutex };
+        stopping_world = true;
+
+        world_acks.store(0, std::memory_order_relaxed);
+        world_epoch.fetch_add(1, std::memory_order_release);
+        unsigned stopped = 0;
+        for (gc_thread* t = thread_registry; t != nullptr; t = t->next_) {
+            if (t == current_thread || t->stack_ == nullptr)
+                continue;
+            t->stack_->top.store(nullptr, std::memory_order_relaxed);
+            if (pthread_kill(t->stack_->handle, GC_SUSPEND_SIGNAL) == 0)
+                ++stopped;
+        }
+        while (world_acks.load(std::memory_order_acquire) != stopped)
+            std::this_thread::yield();
+
+        mark_stacks(young_only);
+#else
+        (void)young_only;
+        (void)marking;
+        (void)objects;
+#endif
+    }
+
+    gc_collector::stopped_world::~stopped_world()
+    {
+#if GC_STACK_SCANNING
+        if (marking_ != nullptr)
+            marking_->thaw();
+        if (!lock_.owns_lock())
+            return;
+        world_epoch.fetch_add(1, std::memory_order_release);
+        for (gc_thread* t = thread_registry; t != nullptr; t = t->next_)
+            if (t != current_thread && t->stack_ != nullptr)
+                pthread_kill(t->stack_->handle, GC_RESUME_SIGNAL);
+        stopping_world = false;
+#endif
+    }
+
+    // Mark the block each stack word names.  The world is stopped, and the
+    // registry locked by stopped_world.
+    void gc_collector::mark_stacks(bool young_only)
+    {
+#if GC_STACK_SCANNING
+        auto mark = [young_only](gc_object* o) {
+            if (!(young_only && o->old))
+                o->set_marked(true);
+        };
+        for (gc_thread* t = thread_registry; t != nullptr; t = t->next_) {
+            if (t->stack_ == nullptr)
+                continue;
+            if (t == current_thread)
+                for_each_own_root(t->stack_->base, mark);
+            else if (const char* top = t->stack_->top.load(std::memory_order_relaxed))
+                for_each_stack_root(top, t->stack_->base, mark);
+        }
+#else
+        (void)young_only;
+#endif
+    }
+
+    // ─────────────────────────────────────────────────────────────────────────────
+    // gc_base_ptr – reference-count helpers
+    // ─────────────────────────────────────────────────────────────────────────────
+
+    // Increment root_ref_cnt.  Requires the lock only when going 0 → 1 while
+    // the collector is reading root counts.
+    void gc_base_ptr::inc_root(gc_object* o) noexcept
+    {
+        int cnt = o->root_ref_cnt.load(std::memory_order_acquire);
+        while (cnt != 0) {
+            if (o->root_ref_cnt.compare_exchange_weak(cnt, cnt + 1,
+                std::memory_order_acq_rel,
+                std::memory_order_acquire))
+            {
+                return;
+            }
+            // compare_exchange_weak updated cnt on failure – retry automatically.
+        }
+        if (gc_collector::try_first_root(o))
+            return;
+
+        // The collector may be examining this object; hold the lock of its heap.
+        gc_collector::note_root_slow_path();
+        std::scoped_lock lock{ gc_collector::heap_mutex(o) };
+        o->root_ref_cnt.fetch_add(1, std::memory_order_relaxed);
+        gc_collector::shade(o);
+    }
+
+    bool gc_collector::try_first_root(gc_object* o) noexcept
+    {
+        gc_thread* t = current_thread;
+        if (t == nullptr) {
+            try {
+                t = gc_thread::attach();
+            }
+            catch (const std::bad_alloc&) {
+            }
+            if (t == nullptr)
+                return false;
+        }
+
+        // Mirrors gc_thread::enter(): either the collector's publish_young()
+        // waits for this increment, or it is seen here to have started.
+        t->allocating_.store(true, std::memory_order_relaxed);
+        gc_light_fence();
+        const bool unlocked = gc_roots_locked.load(std::memory_order_relaxed) == 0;
+        if (unlocked)
+            o->root_ref_cnt.fetch_add(1, std::memory_order_relaxed);
+        t->allocating_.store(false, std::memory_order_release);
+        return unlocked;
+    }
+
+    // Decrement root_ref_cnt.  Never needs the lock.
+    void gc_base_ptr::dec_root(gc_object* o) noexcept
+    {
+        o->root_ref_cnt.fetch_sub(1, std::memory_order_relaxed);
+    }
+
+    void gc_base_ptr::remember(gc_object* owner, gc_object* target)
+    {
+        std::scoped_lock lock{ gc_mutex };
+        gc_collector::remember(owner, target);
+    }
+
+    // ─────────────────────────────────────────────────────────────────────────────
+    // gc_base_ptr – constructor
+    // ─────────────────────────────────────────────────────────────────────────────
+
+    gc_base_ptr::gc_base_ptr(gc_object* o)
+    {
+        // Decide pointer type based on whether `this` falls inside the object
+        // currently being constructed on this thread.
+        type = (current &&
+            current->start() <= static_cast<void*>(this) &&
+            static_cast<void*>(this) < current->end())
+            ? PtrType::GC_HEAP
+            : PtrType::ROOT;
+
+        if (type == PtrType::GC_HEAP) {
+            // Members of a mapped type are found through the map instead.
+            const bool linked = !gc_types[current->type]->mapped;
+            if (o) {
+                const auto lock = gc_collector::barrier_lock(o);
+                gc_collector::remember(current, o);
+                gc_collector::shade(o);
+                object.store(o, std::memory_order_relaxed);
+                if (linked) {
+                    next.store(current->first.load(std::memory_order_relaxed),std::memory_order_relaxed);
+                    current->first.store(this, std::memory_order_relaxed);
+                }
+            }
+            else if (!linked) {
+                object.store(nullptr, std::memory_order_relaxed);
+            }
+            else {
+                object.store(nullptr, std::memory_order_relaxed);
+                next.store(current->first.load(std::memory_order_relaxed),std::memory_order_relaxed);
+                // Release fence ensures next is visible before first is updated.
+                atomic_thread_fence(std::memory_order_release);
+                current->first.store(this, std::memory_order_relaxed);
+            }
+        }
+        else {
+            // ROOT pointer (lives on the stack or in static storage).
+            object.store(o, std::memory_order_relaxed);
+            next.store(nullptr, std::memory_order_relaxed);
+            if (o) inc_root(o);
+        }
+    }
+
+    // ─────────────────────────────────────────────────────────────────────────────
+    // gc_base_ptr – move constructor
+    // ─────────────────────────────────────────────────────────────────────────────
+
+    gc_base_ptr::gc_base_ptr(gc_base_ptr&& o)
+    {
+        type = (current &&
+            current->start() <= static_cast<void*>(this) &&
+            static_cast<void*>(this) < current->end())
+            ? PtrType::GC_HEAP
+            : PtrType::ROOT;
+
+        gc_object* o2 = o.object.load(std::memory_order_relaxed);
+
+        if (type == PtrType::GC_HEAP) {
+            const bool linked = !gc_types[current->type]->mapped;
+            if (o2) {
+                const auto lock = gc_collector::barrier_lock(o2);
+                gc_collector::remember(current, o2);
+                gc_collector::shade(o2);
+                object.store(o2, std::memory_order_relaxed);
+                if (linked) {
+                    next.store(current->first.load(std::memory_order_relaxed),std::memory_order_relaxed);
+                    current->first.store(this, std::memory_order_relaxed);
+                }
+            }
+            else if (!linked) {
+                object.store(nullptr, std::memory_order_relaxed);
+            }
+            else {
+                object.store(nullptr, std::memory_order_relaxed);
+                next.store(current->first.load(std::memory_order_relaxed),std::memory_order_relaxed);
+                atomic_thread_fence(std::memory_order_release);
+                current->first.store(this, std::memory_order_relaxed);
+            }
+        }
+        else {
+            object.store(o2, std::memory_order_relaxed);
+            next.store(nullptr, std::memory_order_relaxed);
+            if (o2) {
+                if (o.type == PtrType::ROOT) {
+                    // Steal the reference: no net change to root_ref_cnt.
+                    o.object.store(nullptr, std::memory_order_relaxed);
+                }
+                else {
+                    inc_root(o2);
+                }
+            }
+        }
+    }
+
+    // ─────────────────────────────────────────────────────────────────────────────
+    // gc_base_ptr – assignment operators
+    // ─────────────────────────────────────────────────────────────────────────────
+
+    void gc_base_ptr::operator=(nullptr_t)
+    {
+        if (type == PtrType::GC_HEAP) {
+            object.store(nullptr, std::memory_order_relaxed);
+        }
+        else {
+            gc_object* o = object.exchange(nullptr, std::memory_order_relaxed);
+            if (o) dec_root(o);
+        }
+    }
+
+    void gc_base_ptr::operator=(const gc_base_ptr& o)
+    {
+        gc_object* o1 = object.load(std::memory_order_relaxed);
+        gc_object* o2 = o.object.load(std::memory_order_relaxed);
+        if (o1 == o2) return;
+
+        if (type == PtrType::GC_HEAP) {
+            if (o2) {
+                const auto lock = gc_collector::barrier_lock(o2);
+                gc_collector::remember_store(this, o2);
+                gc_collector::shade(o2);
+                object.store(o2, std::memory_order_relaxed);
+            }
+            else {
+                object.store(nullptr, std::memory_order_relaxed);
+            }
+        }
+        else {
+            if (o1) {
+                dec_root(o1);
+            }
+            object.store(o2, std::memory_order_relaxed);
+            if (o2) {
+                inc_root(o2);
+            }
+        }
+    }
+
+    void gc_base_ptr::operator=(gc_base_ptr&& o)
+    {
+        gc_object* o1 = object.load(std::memory_order_relaxed);
+        gc_object* o2 = o.object.load(std::memory_order_relaxed);
+        if (o1 == o2) return;
+
+        if (type == PtrType::GC_HEAP) {
+            if (o2) {
+                const auto lock = gc_collector::barrier_lock(o2);
+                gc_collector::remember_store(this, o2);
+                gc_collector::shade(o2);
+                object.store(o2, std::memory_order_relaxed);
+            }
+            else {
+                object.store(nullptr, std::memory_order_relaxed);
+            }
+        }
+        else {
+            if (o.type == PtrType::ROOT) {
+                // Swap: reuse both reference counts, no net change.
+                object.store(o2, std::memory_order_relaxed);
+                o.object.store(o1, std::memory_order_relaxed);
+            }
+            else {
+                if (o1) {
+                    dec_root(o1);
+                }
+                object.store(o2, std::memory_order_relaxed);
+                if (o2) {
+                    inc_root(o2);
+                }
+            }
+        }
+    }
+
+    // ─────────────────────────────────────────────────────────────────────────────
+    // gc_base_ptr – reset / destructor
+    // ─────────────────────────────────────────────────────────────────────────────
+
+    void gc_base_ptr::reset()
+    {
+        if (type == PtrType::GC_HEAP) {
+            object.store(nullptr, std::memory_order_relaxed);
+        }
+        else {
+            gc_object* o = object.exchange(nullptr, std::memory_order_relaxed);
+            if (o) {
+                dec_root(o);
+            }
+        }
+    }
+
+    gc_base_ptr::~gc_base_ptr()
+    {
+        if (type == PtrType::ROOT) {
+            gc_object* o = object.load(std::memory_order_relaxed);
+            if (o) {
+                dec_root(o);
+            }
+        }
+    }
+
+    // ─────────────────────────────────────────────────────────────────────────────
+    // gc_collect
+    // ─────────────────────────────────────────────────────────────────────────────
+
+    void gc_collect()
+    {
+        gc_collector::collect(gc_collector::kind::full);
+    }
+
+    void gc_collect_minor()
+    {
+        gc_collector::collect(gc_collector::kind::minor);
+    }
+
+    std::size_t gc_compact(double max_occupancy)
+    {
+        return gc_collector::compact(max_occupancy);
+    }
+
+    void gc_set_generational(const generational_config& config)
+    {
+        gc_collector::set_generational(config);
+    }
+
+    void gc_set_incremental(const incremental_config& config)
+    {
+        gc_collector::set_incremental(config);
+    }
+
+    void gc_set_heap(const heap_config& config)
+    {
+        gc_collector::set_heap(config);
+    }
+
+    heap_stats gc_stats()
+    {
+        return gc_collector::read_stats();
+    }
+
+    void gc_set_callbacks(collection_callbacks callbacks)
+    {
+        gc_collector::set_callbacks(std::move(callbacks));
+    }
+
+    bool gc_step(std::chrono::microseconds budget)
+    {
+        return gc_collector::step(budget);
+    }
+
+    void start_background_collector(const background_config& config)
+    {
+        gc_collector::start_background(config);
+    }
+
+    void gc_set_mark_workers(unsigned n)
+    {
+        if (n == 0)
+            n = std::max(1u, std::thread::hardware_concurrency());
+        markers.workers.store(n, std::memory_order_relaxed);
+    }
+
+    void stop_background_collector()
+    {
+        gc_collector::stop_background();
+    }
+
+    void gc_set_finalizers(const finalizer_config& config)
+    {
+        gc_collector::set_finalizers(config);
+    }
+
+    std::size_t run_finalizers(std::chrono::microseconds budget)
+    {
+        return gc_collector::run_finalizers(budget);
+    }
+
+    void* gc_allocate_untyped(std::size_t bytes, bool zeroed)
+    {
+        return gc_collector::allocate_untyped(bytes, zeroed);
+    }
+
+    bool gc_free_untyped(void* p) noexcept
+    {
+        return gc_collector::free_untyped(p);
+    }
+
+    bool gc_enable_stack_scanning()
+    {
+        return gc_collector::enable_stack_scanning();
+    }
+
+    void gc_register_thread()
+    {
+        gc_collector::register_thread();
+    }
+
+    void gc_collector::collect(kind k)
+    {
+        const std::shared_ptr<const collection_callbacks> hooks = begin_callbacks();
+
+        // ── Phases 1-3 run while the mutex is held ────────────────────────────────
+        garbage_list buffer;
+        std::vector<gc_object*>& garbage = buffer.items;
+        const bool explicit_full = k == kind::full;
+        collection_record record;
+
+        {
+            std::unique_lock lock = lock_swept();
+            const gc_clock::time_point locked = gc_clock::now();
+            current_record = { .kind = collection_kind::slice };
+
+            // Stacks change between slices: with stack scanning every
+            // collection is a single pause.
+            const bool sliced = k == kind::automatic && !stack_scanning.load(std::memory_order_relaxed);
+            if (sliced && cycle.phase != cycle_phase::idle) {
+                current_record.completed = advance(locked + incremental.pause_budget, garbage);
+            }
+            else if (sliced && incremental.enabled &&
+                     (!generational.enabled || old_objects > major_threshold)) {
+                begin_cycle();
+                current_record.completed = advance(locked + incremental.pause_budget, garbage);
+            }
+            else {
+                // An explicit collection drops an unfinished cycle: its grey
+                // and black objects predate whatever died since, so it
+                // restarts as a full collection.
+                if (cycle.phase != cycle_phase::idle) {
+                    abandon_cycle();
+                    k = kind::full;
+                }
+
+                set_roots_locked(true);
+                collecting_scope const collecting;
+
+                publish_young();
+                enroll();
+
+                if (!generational.enabled)
+                    k = kind::full;
+                else if (k == kind::automatic)
+                    k = old_objects > major_threshold ? kind::full : kind::minor;
+
+                current_record.kind = k == kind::minor ? collection_kind::minor : collection_kind::full;
+                if (k == kind::minor)
+                    minor(garbage);
+                else
+                    full(garbage);
+            }
+
+            close_record(record, garbage, locked);
+            // lock is released here, before destructors are invoked.
+        }
+
+        const gc_clock::time_point destroy_start = gc_clock::now();
+        destroy(garbage);
+
+        // Automatic collections leave the rest to the allocators.
+        if (explicit_full)
+            arena.finish_sweep();
+
+        end_collection(record, destroy_start, hooks);
+    }
+
+    bool gc_collector::step(std::chrono::microseconds budget)
+    {
+        if (stack_scanning.load(std::memory_order_acquire)) {
+            collect(kind::full);
+            return true;
+        }
+        const std::shared_ptr<const collection_callbacks> hooks = begin_callbacks();
+
+        garbage_list buffer;
+        std::vector<gc_object*>& garbage = buffer.items;
+        collection_record record;
+        {
+            std::unique_lock lock = lock_swept();
+            const gc_clock::time_point locked = gc_clock::now();
+            current_record = { .kind = collection_kind::slice };
+            if (cycle.phase == cycle_phase::idle)
+                begin_cycle();
+            current_record.completed = advance(locked + budget, garbage);
+
+            close_record(record, garbage, locked);
+        }
+        const gc_clock::time_point destroy_start = gc_clock::now();
+        destroy(garbage);
+        end_collection(record, destroy_start, hooks);
+        return record.completed;
+    }
+
+    // gc_mutex, once the previous collection has been swept completely.  The
+    // sweeping runs destructors, so it is done here, before locking.
+    std::unique_lock<std::mutex> gc_collector::lock_swept()
+    {
+        while (true) {
+            arena.finish_sweep();
+            std::unique_lock lock{ gc_mutex };
+            if (!arena.sweep_pending())
+                return lock;
+        }
+    }
+
+    // Phase 0: take over the young lists.  After the heavy fence no thread can
+    // start a lock-free allocation; wait out those already inside one.
+    void gc_collector::publish_young()
+    {
+        gc_heavy_fence();
+
+        gc_deferring_lock registry{ thread_registry_mutex };
+        for (gc_thread* t = thread_registry; t != nullptr; t = t->next_) {
+            while (t->allocating_.load(std::memory_order_acquire))
+                std::this_thread::yield();
+            gc_collector::admit(t->young_);
+            t->young_.clear();
+        }
+    }
+
+    // Set the live bits of everything published since the last collection,
+    // which is white even if a barrier greyed it while unpublished.  Only
+    // ever done with no sweep pending: a sweep frees every live, unmarked
+    // block of its chunk.
+    void gc_collector::enroll()
+    {
+        for (gc_object* o : incoming) {
+            o->set_marked(false);
+            arena.enroll(o, gc_types[o->type]->destroy != nullptr);
+        }
+        if (generational.enabled)
+            nursery.insert(nursery.end(), incoming.begin(), incoming.end());
+        enrolled_objects += incoming.size();
+        incoming.clear();
+    }
+
+    // Only the pause for marking: afterwards every chunk is queued for a lazy
+    // sweep, which frees what is left unmarked and clears the rest.  In
+    // generational mode the nursery is swept right away instead, as the
+    // nursery list must not keep dead entries.
+    void gc_collector::full(std::vector<gc_object*>& garbage)
+    {
+        mark_stack& pending = buffers.marking;
+
+        // Phase 1: seed pending from root-referenced objects and Local<> roots.
+        // Phase 2: transitively mark all reachable objects.  Repeated after
+        // a mark-stack overflow, when seeding also resumes the marked objects.
+        // Blocks named from a stack start out marked, hence resumed too.
+        {
+            stopped_world const stopped{ false, &pending, enrolled_objects };
+            do {
+                pending.overflowed = false;
+                seed_heap(pending);
+                for_each_local(arena, [&](gc_object* o) {
+                    if (!o->marked())
+                        pending.push(o);
+                });
+                trace(pending, false);
+            } while (pending.overflowed);
+        }
+
+        // Phase 3: queue the chunks for sweeping.
+        finish_cycle(garbage);
+    }
+
+    // Minor collection: only the nursery is traced and swept.  Roots are the
+    // root-referenced young objects plus whatever the remembered set points
+    // at; old objects are never visited.
+    void gc_collector::minor(std::vector<gc_object*>& garbage)
+    {
+        gc_counter.store(generational.nursery_size, std::memory_order_relaxed);
+        if (nursery.empty()) {
+            set_roots_locked(false);
+            return;
+        }
+        mark_stack& pending = buffers.marking;
+
+        {
+            stopped_world const stopped{ true, &pending, nursery.size() };
+            do {
+                pending.overflowed = false;
+                seed(nursery, pending);
+                for_each_local(arena, [&](gc_object* o) {
+                    if (!o->old && !o->marked())
+                        pending.push(o);
+                });
+                for (gc_object* r : remembered_set) {
+                    for_each_child(r, [&](gc_object* o) {
+                        if (!o->old && !o->marked()) {
+                            pending.push(o);
+                        }
+                    });
+                }
+                trace(pending, true);
+            } while (pending.overflowed);
+        }
+
+        sweep(nursery, garbage);
+        current_record.marked_objects = nursery.size();
+        for (gc_object* o : nursery) {
+            o->set_marked(false);
+            current_record.marked_bytes += gc_arena::block_size(o);
+        }
+
+        // Drop entries whose young children were all promoted, before promote()
+        // adds the newly old objects that still point into the nursery.
+        std::erase_if(remembered_set, [](gc_object* o) {
+            if (has_young_child(o))
+                return false;
+            o->remembered = false;
+            return true;
+        });
+        promote();
+        set_roots_locked(false);
+    }
+
+    // Queue @p c if it is a root not marked yet, or its unmarked children if
+    // it is marked.  Before the first trace nothing is marked; after a
+    // mark-stack overflow these are all that a dropped push may have hidden.
+    void gc_collector::reseed(gc_object* c, mark_stack& pending, bool young_only)
+    {
+        if (!c->marked()) {
+            if (c->root_ref_cnt.load(std::memory_order_relaxed) != 0)
+                pending.push(c);
+            return;
+        }
+        for_each_child(c, [&](gc_object* o) {
+            if (!o->marked() && !(young_only && o->old))
+                pending.push(o);
+        });
+    }
+
+    // Queue the root-referenced objects of the nursery @p space.
+    void gc_collector::seed(std::vector<gc_object*>& space, mark_stack& pending)
+    {
+        for (gc_object* c : space)
+            reseed(c, pending, true);
+    }
+
+    // Call @p f on every object of @p space held by a Local<>.  Caller holds
+    // the heap's lock, after a heavy fence against the slot stores.
+    template <typename F>
+    void gc_collector::for_each_local(const gc_arena& space, F&& f)
+    {
+        // A stopped world keeps the registry locked already.
+        std::optional<gc_deferring_lock<std::mutex>> registry;
+        if (!stopping_world)
+            registry.emplace(thread_registry_mutex);
+        for (gc_thread* t = thread_registry; t != nullptr; t = t->next_) {
+            const gc_local_slots& l = t->locals_;
+            const std::size_t n = l.top.load(std::memory_order_acquire);
+            for (std::size_t i = 0; i != n; ++i) {
+                gc_object* o = l.slots[i].load(std::memory_order_relaxed);
+                if (o != nullptr && gc_arena::chunk_of(o)->arena == &space)
+                    f(o);
+            }
+        }
+    }
+
+    // Queue every root-referenced object on the heap, walking the live bitmaps.
+    void gc_collector::seed_heap(mark_stack& pending)
+    {
+        for_each_enrolled([&](gc_object* c) { reseed(c, pending, false); });
+    }
+
+    // Mark everything reachable from @p pending, short of what an overflow drops.
+    void gc_collector::trace(mark_stack& pending, bool young_only)
+    {
+        const unsigned workers = markers.workers.load(std::memory_order_relaxed);
+        const std::size_t heap = young_only ? nursery.size() : enrolled_objects;
+        if (workers > 1 && heap >= parallel_mark_min && !pending.empty() && !pending.frozen()) {
+            trace_parallel(pending, young_only, workers);
+            return;
+        }
+        drain(pending, young_only);
+    }
+
+    void gc_collector::drain(mark_stack& pending, bool young_only)
+    {
+        while (!pending.empty()) {
+            gc_object* c = pending.pop();
+            if (c->marked()) {
+                continue;
+            }
+            c->set_marked(true);
+            for_each_child(c, [&](gc_object* o) {
+                if (!o->marked() && !(young_only && o->old)) {
+                    pending.push(o); // look here once
+                }
+            });
+        }
+    }
+
+    // ─────────────────────────────────────────────────────────────────────────────
+    // Parallel marking
+    // ─────────────────────────────────────────────────────────────────────────────
+
+    // Roots are dealt out round-robin; from there each marker works a private
+    // stack, sharing its older half whenever its deque has run dry, and steals
+    // half of another deque when out of work.  The mark bit is claimed with a
+    // test-and-set, so each object is scanned once.  The trace is complete
+    // when every marker is idle: only active markers add to the deques, and
+    // a marker drains its own deque before going idle.
+    void gc_collector::trace_parallel(mark_stack& pending, bool young_only, unsigned workers)
+    {
+        if (!buffers.job || buffers.job->deques.size() != workers)
+            buffers.job = std::make_unique<mark_job>(workers);
+        mark_job& job = *buffers.job;
+        job.reset(young_only);
+
+        // The roots stay on the collecting thread's stack if there is no room for them.
+        try {
+            for (mark_deque& d : job.deques)
+                d.items.reserve(pending.size() / workers + 1);
+            for (std::size_t i = 0; i < pending.size(); ++i)
+                job.deques[i % workers].items.push_back(pending.items[i]);
+            pending.items.clear();
+        }
+        catch (const std::bad_alloc&) {
+            for (mark_deque& d : job.deques)
+                d.items.clear();
+        }
+        for (mark_deque& d : job.deques)
+            d.size.store(d.items.size(), std::memory_order_relaxed);
+
+        {
+            std::scoped_lock lock{ markers.mutex };
+            while (markers.started < workers - 1)
+                std::thread(mark_helper_main, ++markers.started).detach();
+            markers.job = &job;
+            markers.busy = workers - 1;
+            ++markers.generation;
+        }
+        markers.wake.notify_all();
+
+        mark_worker(job, 0, pending);
+
+        std::unique_lock lock{ markers.mutex };
+        markers.finished.wait(lock, [] { return markers.busy == 0; });
+        markers.job = nullptr;
+        pending.overflowed = job.overflowed.load(std::memory_order_relaxed);
+    }
+
+    void gc_collector::mark_worker(mark_job& job, unsigned id, mark_stack& stack)
+    {
+        // Whoever finishes the trace sees the flag: the markers' exits are synchronized.
+        struct report_overflow {
+            mark_job&   job;
+            mark_stack& stack;
+            ~report_overflow()
+            {
+                if (stack.overflowed)
+                    job.overflowed.store(true, std::memory_order_relaxed);
+                stack.overflowed = false;
+            }
+        } const report{ job, stack };
+
+        const auto n = static_cast<unsigned>(job.deques.size());
+        mark_deque& own = job.deques[id];
+
+        while (true) {
+            while (!stack.empty()) {
+                gc_object* c = stack.pop();
+                if (c->test_and_mark()) {
+                    continue;   // claimed by another marker
+                }
+                for_each_child(c, [&](gc_object* o) {
+                    if (!o->marked() && !(job.young_only && o->old)) {
+                        stack.push(o);
+                    }
+                });
+
+                if (stack.size() >= mark_share_size && own.size.load(std::memory_order_relaxed) == 0) {
+                    std::vector<gc_object*>& items = stack.items;
+                    const auto half = static_cast<std::ptrdiff_t>(items.size() / 2);
+                    std::scoped_lock lock{ own.mutex };
+                    try {
+                        own.items.insert(own.items.end(), items.begin(), items.begin() + half);
+                    }
+                    catch (const std::bad_alloc&) {
+                        continue;   // keep it all
+                    }
+                    own.size.store(own.items.size(), std::memory_order_relaxed);
+                    items.erase(items.begin(), items.begin() + half);
+                }
+            }
+
+            if (mark_refill(job, id, stack))
+                continue;
+
+            job.idle.fetch_add(1, std::memory_order_acq_rel);
+            while (true) {
+                if (job.done.load(std::memory_order_acquire))
+                    return;
+                if (job.idle.load(std::memory_order_acquire) == n) {
+                    job.done.store(true, std::memory_order_release);
+                    return;
+                }
+                bool work = false;
+                for (mark_deque& d : job.deques)
+                    work = work || d.size.load(std::memory_order_relaxed) != 0;
+                if (work) {
+                    job.idle.fetch_sub(1, std::memory_order_acq_rel);
+                    break;
+                }
+                std::this_thread::yield();
+            }
+        }
+    }
+
+    // Take everything from our own deque, or half of someone else's.
+    bool gc_collector::mark_refill(mark_job& job, unsigned id, mark_stack& stack)
+    {
+        const auto n = static_cast<unsigned>(job.deques.size());
+        for (unsigned k = 0; k < n; ++k) {
+            mark_deque& d = job.deques[(id + k) % n];
+            if (d.size.load(std::memory_order_relaxed) == 0)
+                continue;
+
+            std::scoped_lock lock{ d.mutex };
+            const std::size_t take = k == 0 ? d.items.size() : (d.items.size() + 1) / 2;
+            if (take == 0)
+                continue;
+            for (std::size_t i = 0; i != take; ++i)
+                stack.push(d.items[i]);
+            d.items.erase(d.items.begin(), d.items.begin() + static_cast<std::ptrdiff_t>(take));
+            d.size.store(d.items.size(), std::memory_order_relaxed);
+            return true;
+        }
+        return false;
+    }
+
+    void gc_collector::mark_helper_main(unsigned id)
+    {
+        mark_stack stack;   // kept for the helper's lifetime
+        std::uint64_t seen = 0;
+
+        std::unique_lock lock{ markers.mutex };
+        while (true) {
+            markers.wake.wait(lock, [&] { return markers.generation != seen; });
+            seen = markers.generation;
+            mark_job* job = markers.job;
+            if (job == nullptr || id >= job->deques.size())
+                continue;   // fewer workers than helpers this time
+
+            lock.unlock();
+            mark_worker(*job, id, stack);
+            lock.lock();
+            if (--markers.busy == 0)
+                markers.finished.notify_all();
+        }
+    }
+
+    // Eager sweep of a list of objects.  Survivors keep their order and their
+    // mark; the dead are retired, so a lazy sweep cannot free them twice.
+    // Done in place: std::stable_partition would allocate its buffer.
+    void gc_collector::sweep(std::vector<gc_object*>& space, std::vector<gc_object*>& garbage)
+    {
+        enrolled_objects -= std::erase_if(space, [&](gc_object* o) {
+            if (o->marked())
+                return false;
+            arena.retire(o);
+            garbage.push_back(o);
+            return true;
+        });
+    }
+
+    // Age the nursery survivors and move those old enough to the old space.
+    void gc_collector::promote()
+    {
+        for (gc_object* o : nursery) {
+            if (o->age < std::numeric_limits<std::uint8_t>::max())
+                ++o->age;
+        }
+        // Set `old` on the whole batch first: edges inside it are not old-to-young.
+        for (gc_object* o : nursery) {
+            if (o->age >= generational.promotion_age && !gc_types[o->type]->conservative)
+                o->old = true;
+        }
+        for (gc_object* o : nursery) {
+            if (o->old && has_young_child(o)) {
+                o->remembered = true;
+                remembered_set.push_back(o);
+            }
+        }
+        old_objects += std::erase_if(nursery, [](const gc_object* o) { return o->old; });
+    }
+
+    bool gc_collector::has_young_child(gc_object* o) noexcept
+    {
+        bool young = false;
+        for_each_child(o, [&](gc_object* c) { young = young || !c->old; });
+        return young;
+    }
+
+    void gc_collector::destroy(std::vector<gc_object*>& garbage) noexcept
+    {
+        // ── Phase 4: run destructors (outside the lock) ───────────────────────────
+        // Destructors may allocate new GC objects, which would call gc_collect()
+        // and try to acquire the mutex.  Releasing it first prevents deadlock.
+        // Unless they are queued for deferred finalization, with their memory.
+        bool deferred = false;
+        for (gc_object*& o : garbage) {
+            if (defer(o)) {
+                o = nullptr;
+                deferred = true;
+            }
+            else {
+                o->~gc_object();
+            }
+        }
+        if (deferred)
+            std::erase(garbage, nullptr);
+
+        // ── Phase 5: return cells to the arena free lists ─────────────────────────
+        // One arena lock for the whole batch; no call into the system allocator
+        // for small objects.
+        arena.deallocate(std::span<gc_object* const>(garbage));
+    }
+
+    void gc_collector::remember(gc_object* owner, gc_object* target)
+    {
+        // Stores into other heaps are made without gc_mutex: test that first.
+        if (!in_default_heap(target) || !generational.enabled || target->old || !owner->old || owner->remembered)
+            return;
+        remembered_set.push_back(owner);
+        owner->remembered = true;
+    }
+
+    void gc_collector::remember_store(const gc_base_ptr* slot, gc_object* target)
+    {
+        if (!in_default_heap(target) || !generational.enabled || target->old)
+            return;
+        // Heap pointers only ever live inside arena blocks.
+        if (auto* owner = static_cast<gc_object*>(arena.block_of(slot)))
+            remember(owner, target);
+    }
+
+    void gc_collector::set_generational(const generational_config& config)
+    {
+        std::unique_lock lock = lock_swept();
+
+        // The spaces are rearranged below: a cycle in progress starts over.
+        if (cycle.phase != cycle_phase::idle)
+            abandon_cycle();
+
+        switch_generational(config);
+    }
+
+    void gc_collector::switch_generational(const generational_config& config)
+    {
+        collecting_scope const collecting;
+
+        publish_young();
+        enroll();
+
+        if (config.enabled && !generational.enabled) {
+            // Everything allocated so far becomes the old space; nothing points
+            // into the (empty) nursery yet.
+            for_each_enrolled([](gc_object* o) {
+                o->old = true;
+                o->age = 0;
+            });
+            old_objects = enrolled_objects;
+            major_threshold = major_threshold_for(old_objects);
+            gc_counter.store(config.nursery_size, std::memory_order_relaxed);
+        }
+        else if (!config.enabled && generational.enabled) {
+            nursery.clear();
+            for_each_enrolled([](gc_object* o) {
+                o->old = false;
+                o->remembered = false;
+            });
+            remembered_set.clear();
+            gc_counter.store(heap_budget, std::memory_order_relaxed);
+        }
+        generational = config;
+    }
+
+    void gc_collector::set_incremental(const incremental_config& config)
+    {
+        std::scoped_lock lock{ gc_mutex };
+        incremental = config;
+    }
+
+    void gc_collector::set_heap(const heap_config& config)
+    {
+        std::scoped_lock lock{ gc_mutex };
+        heap = config;
+        if (generational.enabled) {
+            major_threshold = major_threshold_for(old_objects);
+            return;
+        }
+        if (cycle.phase != cycle_phase::idle)
+            return;
+
+        // Carry over what has been allocated since the last recalibration.
+        const long allocated = heap_budget - gc_counter.load(std::memory_order_relaxed);
+        heap_budget = growth_budget(heap, live_bytes);
+        gc_counter.store(heap_budget - allocated, std::memory_order_relaxed);
+    }
+
+    // ─────────────────────────────────────────────────────────────────────────────
+    // Incremental collection
+    // ─────────────────────────────────────────────────────────────────────────────
+
+    // Start a cycle: every enrolled object is white once swept, so all that is
+    // needed is a snapshot of the young lists and the seeding cursor.
+    void gc_collector::begin_cycle()
+    {
+        set_roots_locked(true);
+        {
+            collecting_scope const collecting;
+            publish_young();
+        }
+        enroll();
+        cycle.phase = cycle_phase::mark;
+        cycle.grey.clear();
+        // Shadow stacks are only read here; later Local<> stores shade.
+        for_each_local(arena, [](gc_object* o) { shade(o); });
+        cycle.seed_chunk = arena.chunks();
+        cycle.seed_granule = 0;
+    }
+
+    /**
+     * Run the cycle until @p deadline or completion; returns true once complete.
+     *
+     * Marking alternates between scanning grey objects and seeding from the
+     * not-yet-visited part of the heap.  The barriers keep it sound in
+     * between slices: a heap store greys its target, and so does a root count
+     * going 0 → 1, so an object can only stay white if it was unreachable
+     * when the cycle started.  Chunks mapped during the cycle are in front of
+     * the seeding cursor and hold no enrolled objects.
+     */
+    bool gc_collector::advance(gc_clock::time_point deadline, std::vector<gc_object*>& garbage)
+    {
+        // Reading the clock costs more than visiting an object; do it in strides.
+        std::size_t work = 0;
+        auto out_of_time = [&] { return (++work & 63) == 0 && gc_clock::now() >= deadline; };
+
+        while (true) {
+            if (out_of_time()) {
+                gc_counter.store(incremental.step_interval, std::memory_order_relaxed);
+                return false;
+            }
+            if (!cycle.grey.empty()) {
+                gc_object* c = cycle.grey.back();
+                cycle.grey.pop_back();
+                for_each_child(c, [](gc_object* o) { shade(o); });
+                continue;
+            }
+            if (void* block = gc_arena::next_live(cycle.seed_chunk, cycle.seed_granule)) {
+                auto* o = static_cast<gc_object*>(block);
+                if (o->root_ref_cnt.load(std::memory_order_relaxed) != 0)
+                    shade(o);
+                continue;
+            }
+
+            // Nothing grey and every root seen.
+            finish_cycle(garbage);
+            return true;
+        }
+    }
+
+    // End of marking, incremental or not: whatever is white is garbage.
+    void gc_collector::finish_cycle(std::vector<gc_object*>& garbage)
+    {
+        cycle.phase = cycle_phase::idle;
+        cycle.grey.clear();
+        set_roots_locked(false);
+
+        std::erase_if(remembered_set, [](gc_object* o) {
+            if (o->marked())
+                return false;
+            o->remembered = false;
+            return true;
+        });
+        if (generational.enabled) {
+            sweep(nursery, garbage);
+            promote();
+        }
+
+        const gc_arena::census_totals totals = arena.census();
+        enrolled_objects = totals.marked_blocks;
+        live_bytes = totals.marked_bytes;
+        arena.schedule_sweep();
+
+        // Nursery garbage is counted by the caller, with the rest of `garbage`.
+        current_record.marked_objects = totals.marked_blocks;
+        current_record.marked_bytes = totals.marked_bytes;
+        current_record.freed_objects = totals.live_blocks - totals.marked_blocks;
+        current_record.freed_bytes = totals.live_bytes - totals.marked_bytes;
+
+        if (generational.enabled) {
+            old_objects = totals.marked_blocks - nursery.size();
+            major_threshold = major_threshold_for(old_objects);
+            gc_counter.store(generational.nursery_size, std::memory_order_relaxed);
+            return;
+        }
+
+        // Recalibrate the automatic-collection counter.
+        heap_budget = growth_budget(heap, live_bytes);
+        gc_counter.store(heap_budget, std::memory_order_relaxed);
+    }
+
+    // Drop the marks of an unfinished cycle; nothing has been swept yet.
+    void gc_collector::abandon_cycle()
+    {
+        cycle.phase = cycle_phase::idle;
+        cycle.grey.clear();
+        set_roots_locked(false);
+        arena.clear_marks();
+    }
+
+    // ─────────────────────────────────────────────────────────────────────────────
+    // Finalization
+    // ─────────────────────────────────────────────────────────────────────────────
+
+    namespace {
+
+        bool finalize_object(void* block) noexcept
+        {
+            auto* o = static_cast<gc_object*>(block);
+            if (gc_collector::defer(o))
+                return false;
+            o->~gc_object();
+            return true;
+        }
+
+        // Move up to finalizer_batch queued objects into @p batch, which has the capacity.
+        void take_finalizer_batch_locked(std::vector<gc_object*>& batch) noexcept
+        {
+            std::vector<gc_object*>& queue = finalizers.queue;
+            const std::size_t n = std::min(queue.size(), finalizer_batch);
+            batch.assign(queue.end() - static_cast<std::ptrdiff_t>(n), queue.end());
+            queue.resize(queue.size() - n);
+        }
+
+        void run_finalizer_batch(std::vector<gc_object*>& batch) noexcept
+        {
+            for (gc_object* o : batch)
+                o->~gc_object();
+            arena.deallocate(std::span<gc_object* const>(batch));
+            batch.clear();
+        }
+
+        void finalizer_main()
+        {
+            std::vector<gc_object*> batch;
+            batch.reserve(finalizer_batch);
+
+            std::unique_lock lock{ finalizers.mutex };
+            while (true) {
+                finalizers.wake.wait(lock, [] {
+                    return !finalizers.queue.empty() || finalizers.running > finalizers.wanted;
+                });
+                if (finalizers.running > finalizers.wanted) {
+                    --finalizers.running;
+                    finalizers.retired.notify_all();
+                    return;
+                }
+
+                take_finalizer_batch_locked(batch);
+                if (!finalizers.queue.empty())
+                    finalizers.wake.notify_one();   // enough for another thread as well
+                ++finalizers.busy;
+                lock.unlock();
+                run_finalizer_batch(batch);
+                lock.lock();
+                if (--finalizers.busy == 0)
+                    finalizers.idle.notify_all();
+            }
+        }
+
+    } // anonymous namespace
+
+    // Queue a dead object of the default heap instead of destroying it.  False
+    // if it is to be destroyed right away.
+    bool gc_collector::defer(gc_object* o) noexcept
+    {
+        if (!finalization_deferred.load(std::memory_order_relaxed))
+            return false;
+        const gc_type& t = *gc_types[o->type];
+        if (t.destroy == nullptr || t.finalize_inline || gc_arena::chunk_of(o)->arena != &arena)
+            return false;
+
+        bool was_empty;
+        {
+            std::scoped_lock lock{ finalizers.mutex };
+            was_empty = finalizers.queue.empty();
+            try {
+                finalizers.queue.push_back(o);
+            }
+            catch (const std::bad_alloc&) {
+                return false;
+            }
+        }
+        if (was_empty)
+            finalizers.wake.notify_one();
+        return true;
+    }
+
+    void gc_collector::set_finalizers(const finalizer_config& config)
+    {
+        {
+            std::scoped_lock lock{ finalizers.mutex };
+            finalizers.wanted = config.threads;
+            while (finalizers.running < finalizers.wanted) {
+                std::thread(finalizer_main).detach();
+                ++finalizers.running;
+            }
+            finalization_deferred.store(config.deferred, std::memory_order_relaxed);
+        }
+        finalizers.wake.notify_all();   // surplus threads exit
+    }
+
+    std::size_t gc_collector::run_finalizers(std::chrono::microseconds budget)
+    {
+        const gc_clock::time_point start = gc_clock::now();
+        std::vector<gc_object*> batch;
+        batch.reserve(finalizer_batch);
+
+        std::size_t done = 0;
+        do {
+            {
+                std::scoped_lock lock{ finalizers.mutex };
+                take_finalizer_batch_locked(batch);
+            }
+            if (batch.empty())
+                break;
+            done += batch.size();
+            run_finalizer_batch(batch);
+        } while (std::chrono::duration_cast<std::chrono::microseconds>(gc_clock::now() - start) < budget);
+        return done;
+    }
+
+    // At exit: stop the finalizer threads, then empty the queue here.
+    void gc_collector::drain_finalizers() noexcept
+    {
+        {
+            std::unique_lock lock{ finalizers.mutex };
+            finalizers.wanted = 0;
+            finalizers.wake.notify_all();
+            finalizers.retired.wait(lock, [] { return finalizers.running == 0; });
+        }
+        try {
+            run_finalizers(std::chrono::microseconds::max());
+        }
+        catch (const std::bad_alloc&) {
+        }
+    }
+
+    // ─────────────────────────────────────────────────────────────────────────────
+    // Compaction
+    // ─────────────────────────────────────────────────────────────────────────────
+
+    // A moved object leaves its new address in its first word, and its old
+    // cell loses the live bit; nothing else in an evacuated chunk is
+    // referenced.
+    gc_object* gc_collector::forwarded(gc_object* o) noexcept
+    {
+        if (!gc_arena::chunk_of(o)->evacuating || gc_live(o))
+            return o;
+        gc_object* to;
+        std::memcpy(&to, static_cast<const void*>(o), sizeof to);
+        return to;
+    }
+
+    // Ptr<T>::ptr directly follows the gc_base_ptr in every Ptr<T>.  It is
+    // rebased only if it pointed into the old copy: aliases elsewhere stay.
+    void gc_collector::relocate(gc_base_ptr& p) noexcept
+    {
+        gc_object* from = p.object.load(std::memory_order_relaxed);
+        if (from == nullptr)
+            return;
+        gc_object* to = forwarded(from);
+        if (to == from)
+            return;
+
+        p.object.store(to, std::memory_order_relaxed);
+        auto* cached = reinterpret_cast<char**>(reinterpret_cast<char*>(&p) + sizeof(gc_base_ptr));
+        const auto offset = static_cast<std::size_t>(*cached - reinterpret_cast<char*>(from));
+        if (*cached >= reinterpret_cast<char*>(from) && offset < gc_arena::block_size(to))
+            *cached = reinterpret_cast<char*>(to) + offset;
+    }
+
+    template <typename F>
+    void gc_collector::for_each_slot(gc_object* o, F&& f)
+    {
+        for (gc_base_ptr* j = o->first.load(std::memory_order_relaxed); j != nullptr; j = j->next.load(std::memory_order_relaxed))
+            f(*j);
+
+        const gc_type& t = *gc_types[o->type];
+        if (!t.mapped)
+            return;
+        auto* element = static_cast<char*>(o->start());
+        for (std::size_t i = o->count(); i != 0; --i, element += t.size) {
+            for (std::size_t offset : t.pointers)
+                f(*reinterpret_cast<gc_base_ptr*>(element + offset));
+        }
+    }
+
+    // Copy @p from to a cell outside the evacuated chunks and leave the
+    // forwarding address behind.  The copy's list of heap pointers, which
+    // all live inside it, is rebased.
+    void gc_collector::move(gc_object* from, std::size_t size)
+    {
+        void* mem = arena.allocate(size);
+        std::memcpy(mem, static_cast<const void*>(from), size);
+        auto* to = static_cast<gc_object*>(mem);
+
+        const auto delta = reinterpret_cast<char*>(to) - reinterpret_cast<char*>(from);
+        auto rebase = [&](std::atomic<gc_base_ptr*>& link) {
+            gc_base_ptr* p = link.load(std::memory_order_relaxed);
+            if (p != nullptr)
+                link.store(reinterpret_cast<gc_base_ptr*>(reinterpret_cast<char*>(p) + delta), std::memory_order_relaxed);
+            return link.load(std::memory_order_relaxed);
+        };
+        for (gc_base_ptr* p = rebase(to->first); p != nullptr; p = rebase(p->next)) {
+        }
+
+        arena.enroll(to, gc_types[to->type]->destroy != nullptr);
+        arena.retire(from);
+        std::memcpy(static_cast<void*>(from), &to, sizeof to);
+    }
+
+    // Queued objects may point at anything that moves: run them all first.
+    void gc_collector::finish_finalizers()
+    {
+        while (true) {
+            run_finalizers(std::chrono::microseconds::max());
+            std::unique_lock lock{ finalizers.mutex };
+            finalizers.idle.wait(lock, [] { return finalizers.busy == 0; });
+            if (finalizers.queue.empty())
+                return;
+        }
+    }
+
+    std::size_t gc_collector::compact(double occupancy)
+    {
+        if (current != nullptr)
+            return 0;
+
+        collect(kind::full);
+        finish_finalizers();
+
+        std::unique_lock lock = lock_swept();
+        set_roots_locked(true);
+        collecting_scope const collecting;
+        publish_young();
+        enroll();
+
+        // No cell may stay cached in an evacuated chunk.
+        {
+            gc_deferring_lock registry{ thread_registry_mutex };
+            for (gc_thread* t = thread_registry; t != nullptr; t = t->next_)
+                t->cells_.flush();
+        }
+
+        // Mark bits pin, until the end.  Raw pointers cannot be fixed up, so
+        // what an untyped block or a stack points at stays too.
+        for_each_enrolled([](gc_object* o) {
+            const gc_type& t = *gc_types[o->type];
+            if (o->root_ref_cnt.load(std::memory_order_relaxed) != 0 || t.pinned)
+                o->set_marked(true);
+            if (t.conservative)
+                for_each_child(o, [](gc_object* c) { c->set_marked(true); });
+        });
+        for_each_local(arena, [](gc_object* o) { o->set_marked(true); });
+        // What the stacks name is marked while the world stands still.
+        { stopped_world const stopped{ false }; }
+
+        std::vector<gc_chunk*> chunks;
+        std::size_t moved = 0;
+        try {
+            chunks = arena.begin_evacuation(occupancy);
+            for (gc_chunk* c : chunks) {
+                gc_chunk*   walk = c;
+                std::size_t granule = 0;
+                while (void* block = gc_arena::next_live(walk, granule)) {
+                    if (walk != c)
+                        break;
+                    auto* o = static_cast<gc_object*>(block);
+                    if (!o->marked()) {
+                        move(o, c->cell_size);
+                        ++moved;
+                    }
+                }
+            }
+        }
+        catch (const std::bad_alloc&) {
+            // Out of fresh chunks: what was moved so far is fixed up below.
+        }
+
+        if (moved != 0) {
+            for_each_enrolled([](gc_object* o) { for_each_slot(o, relocate); });
+            for (gc_object*& o : nursery)
+                o = forwarded(o);
+            for (gc_object*& o : remembered_set)
+                o = forwarded(o);
+        }
+
+        arena.clear_marks();
+        arena.end_evacuation(chunks);
+        set_roots_locked(false);
+        return moved;
+    }
+
+    // ─────────────────────────────────────────────────────────────────────────────
+    // Heaps
+    // ─────────────────────────────────────────────────────────────────────────────
+
+    /// A Heap's collector state, guarded by `mutex` as the default heap's is by gc_mutex.
+    struct gc_heap_state {
+        explicit gc_heap_state(const heap_config& c, bool r = false)
+            : arena(finalize_object, this)
+            , config(c)
+            , budget(growth_budget(c, 0))
+            , region(r)
+        {
+        }
+
+        std::mutex              mutex;
+        gc_arena                arena;      ///< context(): this state
+        std::vector<gc_object*> incoming;   ///< allocated since the last collection, never swept
+        mark_stack              marking;    ///< guarded by mutex
+        heap_config             config;
+        std::size_t             live_bytes{ 0 };
+        long                    budget;     ///< bytes left to allocate before the next automatic collection
+        bool                    region;     ///< a Region's: only its thread allocates, nothing is collected
+    };
+
+    Heap::Heap(const heap_config& config)
+        : state_(std::make_unique<gc_heap_state>(config))
+    {
+    }
+
+    Heap::~Heap()
+    {
+        gc_collector::destroy_heap(*state_);
+    }
+
+    void Heap::collect()
+    {
+        gc_collector::collect_heap(*state_);
+    }
+
+    void Heap::set_config(const heap_config& config)
+    {
+        gc_collector::set_heap_config(*state_, config);
+    }
+
+    Region::Region(bool check_escapes)
+        : state_(std::make_unique<gc_heap_state>(heap_config{}, true))
+        , saved_(current_heap)
+        , check_escapes_(check_escapes)
+    {
+        current_heap = state_.get();
+    }
+
+    Region::~Region()
+    {
+        current_heap = saved_;
+        if (check_escapes_ && gc_collector::region_escaped(*state_))
+            std::terminate();
+        state_->arena.finalize_all();
+        state_->arena.release_all();
+    }
+
+    std::mutex& gc_collector::heap_mutex(const gc_object* o) noexcept
+    {
+        const gc_arena* a = gc_arena::chunk_of(o)->arena;
+        return a == &arena ? gc_mutex : static_cast<gc_heap_state*>(a->context())->mutex;
+    }
+
+    // A Region is never marked: its stores need no lock.
+    std::unique_lock<std::mutex> gc_collector::barrier_lock(const gc_object* o)
+    {
+        const gc_arena* a = gc_arena::chunk_of(o)->arena;
+        if (a == &arena)
+            return std::unique_lock{ gc_mutex };
+        auto* h = static_cast<gc_heap_state*>(a->context());
+        return h->region ? std::unique_lock<std::mutex>{} : std::unique_lock{ h->mutex };
+    }
+
+    // Allocation into a Heap always takes its lock: there is no young list to
+    // hand over, so a collection in progress simply holds allocations up.
+    gc_object* gc_thread::allocate_in(gc_heap_state* h, std::size_t bytes, std::uint16_t type, std::size_t count, bool root)
+    {
+        if (h->region) {
+            auto* o = ::new (h->arena.bump_allocate(bytes)) gc_object(type, count);
+            if (root)
+                o->root_ref_cnt.store(1, std::memory_order_relaxed);
+            h->arena.enroll(o, gc_types[type]->destroy != nullptr);
+            return o;
+        }
+
+        bool collect;
+        {
+            std::scoped_lock lock{ h->mutex };
+            h->budget -= static_cast<long>(bytes);
+            collect = h->budget < 0;
+        }
+        if (collect)
+            gc_collector::collect_heap(*h);
+
+        void* mem = h->arena.allocate(bytes);
+        std::scoped_lock lock{ h->mutex };
+        try {
+            h->incoming.reserve(h->incoming.size() + 1);
+        }
+        catch (...) {
+            h->arena.deallocate(mem);
+            throw;
+        }
 
-    // ─────────────────────────────────────────────────────────────────────────────
-    // gc_object
-    // ─────────────────────────────────────────────────────────────────────────────
+        auto* o = ::new (mem) gc_object(type, count);
+        if (root)
+            o->root_ref_cnt.store(1, std::memory_order_relaxed);
+        h->incoming.push_back(o);
+        return o;
+    }
 
-    gc_object::gc_object() noexcept
-        : end_(this + 1)
-        , destructor([](std::byte*, std::byte*) noexcept {})
+    // As lock_swept(), for a Heap.
+    std::unique_lock<std::mutex> gc_collector::lock_swept(gc_heap_state& h)
     {
-        root_ref_cnt.store(0, std::memory_order_relaxed);
-        first.store(nullptr, std::memory_order_relaxed);
+        while (true) {
+            h.arena.finish_sweep();
+            std::unique_lock lock{ h.mutex };
+            if (!h.arena.sweep_pending())
+                return lock;
+        }
     }
 
-    gc_object::gc_object(void* e, void (*d)(std::byte*, std::byte*) noexcept) noexcept
-        : end_(e)
-        , destructor(d)
+    // Let every 0 → 1 root step that missed the raised gc_roots_locked finish.
+    void gc_collector::wait_for_root_steps()
     {
-        root_ref_cnt.store(0, std::memory_order_relaxed);
-        first.store(nullptr, std::memory_order_relaxed);
+        gc_heavy_fence();
+
+        gc_deferring_lock registry{ thread_registry_mutex };
+        for (gc_thread* t = thread_registry; t != nullptr; t = t->next_) {
+            while (t->allocating_.load(std::memory_order_acquire))
+                std::this_thread::yield();
+        }
     }
 
-    gc_object::~gc_object()
+    void gc_collector::enroll(gc_heap_state& h) noexcept
     {
-        destructor(static_cast<std::byte*>(start()),
-            static_cast<std::byte*>(end()));
+        for (gc_object* o : h.incoming) {
+            o->set_marked(false);
+            h.arena.enroll(o, gc_types[o->type]->destroy != nullptr);
+        }
+        h.incoming.clear();
     }
 
-    // ─────────────────────────────────────────────────────────────────────────────
-    // gc_base_ptr – reference-count helpers
-    // ─────────────────────────────────────────────────────────────────────────────
-
-    // Increment root_ref_cnt.  Requires the lock only when going 0 → 1.
-    void gc_base_ptr::inc_root(gc_object* o) noexcept
+    // A single pause, serial marking, then an eager sweep outside the lock.
+    void gc_collector::collect_heap(gc_heap_state& h)
     {
-        int cnt = o->root_ref_cnt.load(std::memory_order_acquire);
-        while (cnt != 0) {
-            if (o->root_ref_cnt.compare_exchange_weak(cnt, cnt + 1,
-                std::memory_order_acq_rel,
-                std::memory_order_acquire))
+        {
+            std::unique_lock lock = lock_swept(h);
+
+            struct roots_scope {
+                roots_scope()  noexcept { gc_roots_locked.fetch_add(1, std::memory_order_relaxed); }
+                ~roots_scope() noexcept { gc_roots_locked.fetch_sub(1, std::memory_order_relaxed); }
+            };
+
             {
-                return;
+                roots_scope const roots;
+                wait_for_root_steps();
+                enroll(h);
+
+                mark_stack& pending = h.marking;
+                do {
+                    pending.overflowed = false;
+                    gc_chunk*   chunk = h.arena.chunks();
+                    std::size_t granule = 0;
+                    while (void* block = gc_arena::next_live(chunk, granule))
+                        reseed(static_cast<gc_object*>(block), pending, false);
+                    for_each_local(h.arena, [&](gc_object* o) {
+                        if (!o->marked())
+                            pending.push(o);
+                    });
+                    drain(pending, false);
+                } while (pending.overflowed);
             }
-            // compare_exchange_weak updated cnt on failure – retry automatically.
+
+            h.live_bytes = h.arena.census().marked_bytes;
+            h.budget = growth_budget(h.config, h.live_bytes);
+            h.arena.schedule_sweep();
         }
-        // cnt == 0: GC may be examining this object; hold the lock.
-        std::scoped_lock lock{ gc_mutex };
-        o->root_ref_cnt.fetch_add(1, std::memory_order_relaxed);
+        h.arena.finish_sweep();
     }
 
-    // Decrement root_ref_cnt.  Never needs the lock.
-    void gc_base_ptr::dec_root(gc_object* o) noexcept
+    void gc_collector::destroy_heap(gc_heap_state& h) noexcept
     {
-        o->root_ref_cnt.fetch_sub(1, std::memory_order_relaxed);
+        {
+            std::unique_lock lock = lock_swept(h);
+            enroll(h);
+            h.arena.schedule_sweep();   // nothing is marked: everything goes
+        }
+        h.arena.finish_sweep();
+        h.arena.release_all();
     }
 
-    // ─────────────────────────────────────────────────────────────────────────────
-    // gc_base_ptr – constructor
-    // ─────────────────────────────────────────────────────────────────────────────
-
-    gc_base_ptr::gc_base_ptr(gc_object* o)
+    // Ptr roots still counted, or Locals pointing in: ~Region() runs after every
+    // scope nested in it, so any of them outlives the region.
+    bool gc_collector::region_escaped(gc_heap_state& h) noexcept
     {
-        // Decide pointer type based on whether `this` falls inside the object
-        // currently being constructed on this thread.
-        type = (current &&
-            current->start() <= static_cast<void*>(this) &&
-            static_cast<void*>(this) < current->end())
-            ? PtrType::GC_HEAP
-            : PtrType::ROOT;
-
-        if (type == PtrType::GC_HEAP) {
-            if (o) {
-                std::scoped_lock lock{ gc_mutex };
-                object.store(o, std::memory_order_relaxed);
-                next.store(current->first.load(std::memory_order_relaxed),std::memory_order_relaxed);
-                current->first.store(this, std::memory_order_relaxed);
-            }
-            else {
-                object.store(nullptr, std::memory_order_relaxed);
-                next.store(current->first.load(std::memory_order_relaxed),std::memory_order_relaxed);
-                // Release fence ensures next is visible before first is updated.
-                atomic_thread_fence(std::memory_order_release);
-                current->first.store(this, std::memory_order_relaxed);
-            }
-        }
-        else {
-            // ROOT pointer (lives on the stack or in static storage).
-            object.store(o, std::memory_order_relaxed);
-            next.store(nullptr, std::memory_order_relaxed);
-            if (o) inc_root(o);
+        gc_chunk*   chunk = h.arena.chunks();
+        std::size_t granule = 0;
+        while (void* block = gc_arena::next_live(chunk, granule)) {
+            if (static_cast<gc_object*>(block)->root_ref_cnt.load(std::memory_order_relaxed) != 0)
+                return true;
         }
+
+        bool escaped = false;
+        for_each_local(h.arena, [&](gc_object*) { escaped = true; });
+        return escaped;
+    }
+
+    void gc_collector::set_heap_config(gc_heap_state& h, const heap_config& config)
+    {
+        std::scoped_lock lock{ h.mutex };
+        const long allocated = growth_budget(h.config, h.live_bytes) - h.budget;
+        h.config = config;
+        h.budget = growth_budget(config, h.live_bytes) - allocated;
     }
 
     // ─────────────────────────────────────────────────────────────────────────────
-    // gc_base_ptr – move constructor
+    // Parallel construction
     // ─────────────────────────────────────────────────────────────────────────────
 
-    gc_base_ptr::gc_base_ptr(gc_base_ptr&& o)
+    std::size_t gc_construct_chunks(std::size_t bytes) noexcept
     {
-        type = (current &&
-            current->start() <= static_cast<void*>(this) &&
-            static_cast<void*>(this) < current->end())
-            ? PtrType::GC_HEAP
-            : PtrType::ROOT;
+        if (current_heap != nullptr && current_heap->region)
+            return 1;
+        const std::size_t threads = std::max(std::thread::hardware_concurrency(), 1u);
+        return std::clamp<std::size_t>(bytes / gc_parallel_construct_min, 1, threads);
+    }
 
-        gc_object* o2 = o.object.load(std::memory_order_relaxed);
+    namespace {
 
-        if (type == PtrType::GC_HEAP) {
-            if (o2) {
-                std::scoped_lock lock{ gc_mutex };
-                object.store(o2, std::memory_order_relaxed);
-                next.store(current->first.load(std::memory_order_relaxed),std::memory_order_relaxed);
-                current->first.store(this, std::memory_order_relaxed);
-            }
-            else {
-                object.store(nullptr, std::memory_order_relaxed);
-                next.store(current->first.load(std::memory_order_relaxed),std::memory_order_relaxed);
-                atomic_thread_fence(std::memory_order_release);
-                current->first.store(this, std::memory_order_relaxed);
+        /**
+         * Helper threads of gc_run_chunks(), started on first use and parked
+         * between arrays, like the mark helpers.  They serve one array at a
+         * time; with the chunk count capped at the hardware threads, that
+         * keeps construction from oversubscribing the machine.
+         */
+        struct construct_pool {
+            std::mutex              mutex;
+            std::condition_variable wake;        ///< helpers: an array was posted
+            std::condition_variable finished;    ///< poster: every helper left the array
+            unsigned                started{ 0 };
+            unsigned                busy{ 0 };   ///< helpers still inside the current array
+            bool                    taken{ false };
+            std::uint64_t           generation{ 0 };
+
+            // The array being built, set by its poster under the lock.
+            void (*body)(void* ctx, std::size_t chunk) noexcept { nullptr };
+            void*                    ctx{ nullptr };
+            gc_object*               owner{ nullptr };
+            gc_heap_state*           heap{ nullptr };
+            std::size_t              chunks{ 0 };
+            std::atomic<std::size_t> next{ 0 };   ///< first chunk nobody has claimed
+        };
+
+        // Helpers are detached and the pool is never destroyed.
+        construct_pool& constructors = *new construct_pool;
+
+        /// Claim and run chunks of the posted array until none is left.
+        void run_claimed_chunks(void (*body)(void*, std::size_t) noexcept, void* ctx, std::size_t chunks) noexcept
+        {
+            for (std::size_t c; (c = constructors.next.fetch_add(1, std::memory_order_relaxed)) < chunks;)
+                body(ctx, c);
+        }
+
+        void construct_helper_main(std::uint64_t seen)
+        {
+            construct_pool& pool = constructors;
+            std::unique_lock lock{ pool.mutex };
+            while (true) {
+                pool.wake.wait(lock, [&] { return pool.generation != seen; });
+                seen = pool.generation;
+                const auto body = pool.body;
+                void* const ctx = pool.ctx;
+                const std::size_t chunks = pool.chunks;
+                current = pool.owner;
+                current_heap = pool.heap;
+
+                lock.unlock();
+                run_claimed_chunks(body, ctx, chunks);
+                current = nullptr;
+                current_heap = nullptr;
+                lock.lock();
+                if (--pool.busy == 0)
+                    pool.finished.notify_all();
             }
         }
-        else {
-            object.store(o2, std::memory_order_relaxed);
-            next.store(nullptr, std::memory_order_relaxed);
-            if (o2) {
-                if (o.type == PtrType::ROOT) {
-                    // Steal the reference: no net change to root_ref_cnt.
-                    o.object.store(nullptr, std::memory_order_relaxed);
-                }
-                else {
-                    inc_root(o2);
+
+    } // anonymous namespace
+
+    // The helpers claim chunks as they wake; whatever they have not claimed
+    // by the time the caller is done with its own, the caller runs too.  An
+    // array that finds the helpers taken, nested in a constructor or from
+    // another thread, is built by its caller alone.
+    void gc_run_chunks(std::size_t chunks, void (*body)(void* ctx, std::size_t chunk) noexcept, void* ctx)
+    {
+        construct_pool& pool = constructors;
+        {
+            std::unique_lock lock{ pool.mutex };
+            if (pool.taken) {
+                lock.unlock();
+                for (std::size_t c = 0; c != chunks; ++c)
+                    body(ctx, c);
+                return;
+            }
+            pool.taken = true;
+            try {
+                while (pool.started < chunks - 1) {
+                    std::thread(construct_helper_main, pool.generation).detach();
+                    ++pool.started;
                 }
             }
+            catch (const std::system_error&) {
+                // Out of threads: fewer helpers.
+            }
+            pool.body = body;
+            pool.ctx = ctx;
+            pool.owner = current;
+            pool.heap = current_heap;
+            pool.chunks = chunks;
+            pool.next.store(0, std::memory_order_relaxed);
+            pool.busy = pool.started;
+            ++pool.generation;
         }
+        pool.wake.notify_all();
+
+        run_claimed_chunks(body, ctx, chunks);
+
+        std::unique_lock lock{ pool.mutex };
+        pool.finished.wait(lock, [&] { return pool.busy == 0; });
+        pool.taken = false;
     }
 
     // ─────────────────────────────────────────────────────────────────────────────
-    // gc_base_ptr – assignment operators
+    // Statistics
     // ─────────────────────────────────────────────────────────────────────────────
 
-    void gc_base_ptr::operator=(nullptr_t)
+    void gc_collector::note_root_slow_path() noexcept
     {
-        if (type == PtrType::GC_HEAP) {
-            object.store(nullptr, std::memory_order_relaxed);
-        }
-        else {
-            gc_object* o = object.exchange(nullptr, std::memory_order_relaxed);
-            if (o) dec_root(o);
-        }
+        if (gc_thread* t = current_thread)
+            gc_thread::bump(t->counters_.root_slow_paths, 1);
+        else
+            retired.root_slow_paths.fetch_add(1, std::memory_order_relaxed);
     }
 
-    void gc_base_ptr::operator=(const gc_base_ptr& o)
+    heap_stats gc_collector::read_stats()
     {
-        gc_object* o1 = object.load(std::memory_order_relaxed);
-        gc_object* o2 = o.object.load(std::memory_order_relaxed);
-        if (o1 == o2) return;
-
-        if (type == PtrType::GC_HEAP) {
-            if (o2) {
-                std::scoped_lock lock{ gc_mutex };
-                object.store(o2, std::memory_order_relaxed);
-            }
-            else {
-                object.store(nullptr, std::memory_order_relaxed);
-            }
+        heap_stats out;
+        {
+            std::scoped_lock lock{ stats.mutex };
+            out = stats.totals;
+            const std::size_t kept = std::min(stats.recorded, gc_history_length);
+            out.history.reserve(kept);
+            for (std::size_t i = stats.recorded - kept; i != stats.recorded; ++i)
+                out.history.push_back(stats.history[i % gc_history_length]);
         }
-        else {
-            if (o1) {
-                dec_root(o1);
-            }
-            object.store(o2, std::memory_order_relaxed);
-            if (o2) {
-                inc_root(o2);
-            }
+
+        gc_deferring_lock lock{ thread_registry_mutex };
+        out.allocated_objects = retired.allocated_objects.load(std::memory_order_relaxed);
+        out.allocated_bytes = retired.allocated_bytes.load(std::memory_order_relaxed);
+        out.root_slow_paths = retired.root_slow_paths.load(std::memory_order_relaxed);
+        for (gc_thread* t = thread_registry; t != nullptr; t = t->next_) {
+            out.allocated_objects += t->counters_.allocated_objects.load(std::memory_order_relaxed);
+            out.allocated_bytes += t->counters_.allocated_bytes.load(std::memory_order_relaxed);
+            out.root_slow_paths += t->counters_.root_slow_paths.load(std::memory_order_relaxed);
         }
+        return out;
     }
 
-    void gc_base_ptr::operator=(gc_base_ptr&& o)
+    void gc_collector::set_callbacks(collection_callbacks hooks)
     {
-        gc_object* o1 = object.load(std::memory_order_relaxed);
-        gc_object* o2 = o.object.load(std::memory_order_relaxed);
-        if (o1 == o2) return;
+        auto installed = hooks.on_start || hooks.on_end
+            ? std::make_shared<const collection_callbacks>(std::move(hooks))
+            : nullptr;
+        std::scoped_lock lock{ callbacks_mutex };
+        callbacks_installed.store(installed != nullptr, std::memory_order_relaxed);
+        callbacks = std::move(installed);
+    }
 
-        if (type == PtrType::GC_HEAP) {
-            if (o2) {
-                std::scoped_lock lock{ gc_mutex };
-                object.store(o2, std::memory_order_relaxed);
-            }
-            else {
-                object.store(nullptr, std::memory_order_relaxed);
-            }
+    // Run on_start and keep the hooks for end_collection(), unless called from a hook.
+    std::shared_ptr<const collection_callbacks> gc_collector::begin_callbacks()
+    {
+        if (in_callback || !callbacks_installed.load(std::memory_order_relaxed))
+            return nullptr;
+
+        std::shared_ptr<const collection_callbacks> hooks;
+        {
+            std::scoped_lock lock{ callbacks_mutex };
+            hooks = callbacks;
         }
-        else {
-            if (o.type == PtrType::ROOT) {
-                // Swap: reuse both reference counts, no net change.
-                object.store(o2, std::memory_order_relaxed);
-                o.object.store(o1, std::memory_order_relaxed);
-            }
-            else {
-                if (o1) {
-                    dec_root(o1);
-                }
-                object.store(o2, std::memory_order_relaxed);
-                if (o2) {
-                    inc_root(o2);
-                }
-            }
+        if (hooks && hooks->on_start) {
+            in_callback = true;
+            struct reset { ~reset() { in_callback = false; } } const guard;
+            hooks->on_start();
         }
+        return hooks;
     }
 
-    // ─────────────────────────────────────────────────────────────────────────────
-    // gc_base_ptr – reset / destructor
-    // ─────────────────────────────────────────────────────────────────────────────
-
-    void gc_base_ptr::reset()
+    // Take over current_record at the end of the pause, adding the garbage
+    // to be destroyed by the caller.  Caller holds gc_mutex.
+    void gc_collector::close_record(collection_record& record, const std::vector<gc_object*>& garbage,
+                                    gc_clock::time_point locked)
     {
-        if (type == PtrType::GC_HEAP) {
-            object.store(nullptr, std::memory_order_relaxed);
-        }
-        else {
-            gc_object* o = object.exchange(nullptr, std::memory_order_relaxed);
-            if (o) {
-                dec_root(o);
-            }
-        }
+        record = current_record;
+        record.freed_objects += garbage.size();
+        for (gc_object* o : garbage)
+            record.freed_bytes += gc_arena::block_size(o);
+        record.start = locked;
+        record.pause = gc_clock::now() - locked;
     }
 
-    gc_base_ptr::~gc_base_ptr()
+    // Account for a finished collection or slice, then run on_end.
+    void gc_collector::end_collection(collection_record& record, gc_clock::time_point destroy_start,
+                                      const std::shared_ptr<const collection_callbacks>& hooks)
     {
-        if (type == PtrType::ROOT) {
-            gc_object* o = object.load(std::memory_order_relaxed);
-            if (o) {
-                dec_root(o);
-            }
+        record.destroy = gc_clock::now() - destroy_start;
+
+        {
+            std::scoped_lock lock{ stats.mutex };
+            heap_stats& t = stats.totals;
+            if (record.kind == collection_kind::slice)
+                ++t.slices;
+            else if (record.kind == collection_kind::minor)
+                ++t.minor_collections;
+            if (record.completed)
+                ++t.collections;
+            t.freed_objects += record.freed_objects;
+            t.freed_bytes += record.freed_bytes;
+            t.total_pause += record.pause;
+            t.max_pause = std::max(t.max_pause, record.pause);
+            t.total_destroy += record.destroy;
+
+            const auto us = static_cast<std::uint64_t>(
+                std::chrono::duration_cast<std::chrono::microseconds>(record.pause).count());
+            ++t.pause_histogram[std::min<std::size_t>(std::bit_width(us), gc_pause_buckets - 1)];
+
+            stats.history[stats.recorded++ % gc_history_length] = record;
+        }
+
+        if (hooks && hooks->on_end) {
+            in_callback = true;
+            struct reset { ~reset() { in_callback = false; } } const guard;
+            hooks->on_end(record);
         }
     }
 
     // ─────────────────────────────────────────────────────────────────────────────
-    // gc_collect
+    // Background collector
     // ─────────────────────────────────────────────────────────────────────────────
 
-    void gc_collect()
+    void gc_collector::start_background(const background_config& config)
     {
-        // ── Phases 1-3 run while the mutex is held ────────────────────────────────
-        std::vector<gc_object*> garbage;
+        std::scoped_lock lock{ background.mutex };
+        background.config = config;
+        if (background.running)
+            return;
 
-        {
-            std::unique_lock lock{ gc_mutex };
+        background.running = true;
+        background.stopping = false;
+        background.thread = std::thread(background_main);
+        background.active.store(true, std::memory_order_release);
+    }
 
-            if (all_objects.empty()) {
+    void gc_collector::stop_background()
+    {
+        std::thread thread;
+        {
+            std::scoped_lock lock{ background.mutex };
+            if (!background.running)
                 return;
-            }
-            std::vector<gc_object*> pending;
-            pending.reserve(all_objects.size() / 4 + 1);
-
-            // Phase 1: seed pending from root-referenced objects.
-            for (gc_object* c : all_objects) {
-                if (c->root_ref_cnt.load(std::memory_order_relaxed) != 0) {
-                    c->mark = true;
-                    atomic_thread_fence(std::memory_order_acquire);
-                    for (gc_base_ptr* j = c->first.load(std::memory_order_relaxed);
-                        j != nullptr;
-                        j = j->next.load(std::memory_order_relaxed))
-                    {
-                        if (gc_object* o = j->object.load(std::memory_order_relaxed); o) {
-
-                            pending.push_back(o);
-                        }
-                    }
-                }
-                else {
-                    c->mark = false;
-                }
-            }
+            background.stopping = true;
+            background.active.store(false, std::memory_order_relaxed);
+            thread = std::move(background.thread);
+        }
+        background.wake.notify_one();
+        thread.join();
 
-            // Phase 2: transitively mark all reachable objects.
-            while (!pending.empty()) {
-                gc_object* c = pending.back();
-                pending.pop_back();
-                if (c->mark) {
-                    continue;
-                }
-                c->mark = true;
-                atomic_thread_fence(std::memory_order_acquire);
-                for (gc_base_ptr* j = c->first.load(std::memory_order_relaxed);
-                    j != nullptr;
-                    j = j->next.load(std::memory_order_relaxed))
-                {
-                    if (gc_object* o = j->object.load(std::memory_order_relaxed);
-                        o && !o->mark) {
+        std::scoped_lock lock{ background.mutex };
+        background.running = false;
+        background.done.notify_all();
+    }
 
-                        pending.push_back(o); // look here once
-                    }
-                }
-            }
+    bool gc_collector::request_background(long counter)
+    {
+        if (!background.active.load(std::memory_order_acquire))
+            return false;
 
-            // Phase 3: partition – live objects first, garbage last.
-            auto garbage_begin = std::stable_partition(
-                all_objects.begin(), all_objects.end(),
-                [](const gc_object* o) { return o->mark; });
+        // Only the first request after a collection has to wake the thread.
+        if (!background.requested.exchange(true, std::memory_order_acq_rel)) {
+            std::scoped_lock lock{ background.mutex };
+            background.wake.notify_one();
+        }
 
-            garbage.assign(garbage_begin, all_objects.end());
-            all_objects.erase(garbage_begin, all_objects.end());
+        // Destructors run on the collector thread and may allocate: never wait on ourselves.
+        std::unique_lock lock{ background.mutex };
+        if (counter > -background.config.pressure_limit ||
+            std::this_thread::get_id() == background.thread.get_id())
+            return true;
 
-            // Recalibrate the automatic-collection counter.
-            const long new_count = std::max<long>(static_cast<long>(all_objects.size()) * 2L, 1024L);
-            gc_counter.store(new_count, std::memory_order_relaxed);
+        // Under memory pressure: wait for the collection in flight to finish.
+        const std::uint64_t seen = background.completed;
+        background.done.wait(lock, [&] {
+            return background.completed != seen || !background.running || background.stopping;
+        });
+        return true;
+    }
 
-            // lock is released here, before destructors are invoked.
-        }
+    void gc_collector::background_main()
+    {
+        std::unique_lock lock{ background.mutex };
+        long counter_after = gc_counter.load(std::memory_order_relaxed);
 
-        // ── Phase 4: run destructors (outside the lock) ───────────────────────────
-        // Destructors may allocate new GC objects, which would call gc_collect()
-        // and try to acquire the mutex.  Releasing it first prevents deadlock.
-        for (gc_object* o : garbage) {
+        while (!background.stopping) {
+            auto woken = [] {
+                return background.stopping || background.requested.load(std::memory_order_acquire);
+            };
+            if (background.config.period.count() > 0) {
+                // Periodic collections only pay off if something was allocated.
+                if (!background.wake.wait_for(lock, background.config.period, woken) &&
+                    gc_counter.load(std::memory_order_relaxed) >= counter_after)
+                    continue;
+            }
+            else {
+                background.wake.wait(lock, woken);
+            }
+            if (background.stopping)
+                break;
 
-            o->~gc_object();
-        }
+            background.requested.store(false, std::memory_order_relaxed);
+            lock.unlock();
 
-        // ── Phase 5: free memory (re-acquire lock for cache-friendliness) ─────────
-        // Benchmarking (from original) shows that a lock here speeds up
-        // ::operator delete(), probably due to reduced contention on the allocator.
-        {
-            std::scoped_lock lock{ gc_mutex };
-            for (gc_object* o : garbage)
-                ::operator delete(o);
+            // An incremental cycle is run to completion in slices, releasing
+            // gc_mutex in between so allocating threads are not held up.
+            collect(kind::automatic);
+            while (true) {
+                {
+                    std::scoped_lock gc_lock{ gc_mutex };
+                    if (cycle.phase == cycle_phase::idle)
+                        break;
+                }
+                std::this_thread::yield();
+                collect(kind::automatic);
+            }
+            arena.finish_sweep();
+
+            lock.lock();
+            counter_after = gc_counter.load(std::memory_order_relaxed);
+            ++background.completed;
+            background.done.notify_all();
         }
     }
 
@@ -7,18 +7,34 @@
  
  */
 
+#include <array>
 #include <atomic>
+#include <chrono>
 #include <concepts>
 #include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <limits>
 #include <mutex>
+#include <new>
 #include <span>
+#include <tuple>
 #include <type_traits>
 #include <vector>
 
+#include "gc_arena.h"
+
 namespace GC {
 
     class gc_base_ptr;
     class gc_object;
+    class gc_thread;
+    class gc_collector;
+    struct gc_heap_state;
+    template <typename T> class Local;
 
     // ─────────────────────────────────────────────────────────────────────────────
     // Concepts
@@ -38,16 +54,523 @@ namespace GC {
 
     extern std::mutex                gc_mutex;
     extern thread_local gc_object* current;          ///< object under construction (per thread)
-    extern std::vector<gc_object*>   all_objects;       ///< every live gc_object
-    extern std::atomic<long>         gc_counter;        ///< countdown to next automatic collection
+    extern thread_local gc_thread* current_thread;   ///< allocation state of this thread (attached lazily)
+    extern thread_local gc_heap_state* current_heap; ///< Heap that New allocates into, nullptr for the default heap
+    extern std::atomic<long>         gc_counter;        ///< bytes left to allocate before the next automatic collection
+    extern std::atomic<bool>         gc_collecting;     ///< set while gc_collect() owns the young lists
+    extern std::atomic<unsigned>     gc_roots_locked;   ///< heaps whose collector is reading roots: new ones take the heap's lock
+    extern std::atomic<bool>         gc_asymmetric_fences; ///< gc_heavy_fence() is a process-wide barrier
 
     /**
-     * @brief Automatic trigger a garbage-collection.
+     * @brief Mutator half of an asymmetric fence pair.
      *
-     * reaches zero, and once more at program exit.
+     * A compiler barrier only, when the collector can issue a process-wide
+     * barrier (membarrier / FlushProcessWriteBuffers); a full fence otherwise.
+     */
+    inline void gc_light_fence() noexcept
+    {
+        if (gc_asymmetric_fences.load(std::memory_order_relaxed))
+            std::atomic_signal_fence(std::memory_order_seq_cst);
+        else
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+    }
+
+    /// Collector half: orders against every gc_light_fence() in other threads.
+    void gc_heavy_fence() noexcept;
+
+    /**
+     * @brief Run a garbage collection of the default heap now.
+     *
+     * Besides explicit calls, collections also start by themselves: whenever
+     * the allocation budget in gc_counter reaches zero (see gc_set_heap()),
+     * and once more at program exit.  This one is always a full collection,
+     * in generational mode too.  Unlike an automatic collection, which leaves
+     * the heap to be swept lazily by later allocations, it sweeps everything
+     * before returning, so every unreachable object has been destroyed, or
+     * queued for deferred finalization; see gc_set_finalizers().
      */
     void gc_collect();
 
+    /// Collect the nursery only in generational mode; a full collection otherwise.
+    void gc_collect_minor();
+
+    /**
+     * @brief Collect, then move the survivors out of sparsely used chunks.
+     *
+     * Every small chunk whose live objects fill at most @p max_occupancy of
+     * it is evacuated into the free cells of fuller chunks, or into fresh
+     * ones; emptied chunks are unmapped.  An object is moved with memcpy;
+     * heap pointers to it, both `object` and the cached `Ptr<T>::ptr`, are
+     * updated.  Objects held by a root Ptr<> or a Local<> are pinned, as are
+     * large objects and the types that specialise gc_pinned.
+     *
+     * The collector cannot stop other threads, so the caller must make sure
+     * that no other thread touches, allocates or collects objects of the
+     * default heap meanwhile.  A raw pointer or reference into an object
+     * (get(), operator->) survives the call only if the object is pinned,
+     * and so does a pointer into the default heap held by an object of a
+     * Heap or a Region.  Objects queued for deferred finalization are
+     * destroyed first.  Does nothing from within the constructor of a
+     * managed object.
+     *
+     * @return the number of objects moved.
+     */
+    std::size_t gc_compact(double max_occupancy = 0.5);
+
+    /// Settings for the heap-growth trigger of automatic collections.
+    struct heap_config {
+        std::size_t target_heap{ 4u << 20 };   ///< heap size in bytes below which no automatic collection starts
+        double      growth_factor{ 2.0 };      ///< the heap may grow to this multiple of the live bytes of the last collection
+        std::size_t soft_limit{ 0 };           ///< collect more often rather than grow past this many bytes (0: no limit)
+    };
+
+    /**
+     * @brief Tune when automatic collections run.
+     *
+     * Allocations are charged by size, header included.  After a full
+     * collection that left `live` bytes, the next automatic one starts once
+     * the heap has grown to `max(live * growth_factor, target_heap)`, capped
+     * at `soft_limit` while that still leaves some headroom: a heap whose
+     * live data approaches the limit is collected ever more often instead of
+     * growing, but it is allowed to exceed the limit rather than thrash.
+     * Takes effect from the current point on.  In generational mode
+     * `nursery_size` paces the minor collections and `growth_factor` the old
+     * space.
+     */
+    void gc_set_heap(const heap_config& config);
+
+    /// Settings for the opt-in generational mode.
+    struct generational_config {
+        bool     enabled{ false };
+        unsigned promotion_age{ 2 };           ///< minor collections survived before moving to the old space
+        long     nursery_size{ 256 * 1024 };   ///< bytes allocated between two minor collections
+    };
+
+    /**
+     * @brief Switch generational collection on or off.
+     *
+     * Objects alive when it is switched on start out in the old space.  While
+     * enabled, automatic collections are minor ones, and a full collection runs
+     * once the old space has grown by heap_config::growth_factor since the
+     * previous full one.
+     */
+    void gc_set_generational(const generational_config& config);
+
+    /// Settings for incremental collection.
+    struct incremental_config {
+        bool                      enabled{ false };
+        std::chrono::microseconds pause_budget{ 1000 };   ///< longest automatic slice under gc_mutex
+        long                      step_interval{ 64 * 1024 };  ///< bytes allocated between two automatic slices
+    };
+
+    /**
+     * @brief Switch incremental collection on or off.
+     *
+     * While enabled, an automatic collection starts a cycle whose marking is
+     * spread over slices of at most `pause_budget`, one every `step_interval`
+     * bytes allocated.  Sweeping is lazy, as after any full collection.  In
+     * generational mode this applies to full collections; minor ones stay in
+     * a single pause.
+     */
+    void gc_set_incremental(const incremental_config& config);
+
+    /**
+     * @brief Advance the incremental cycle for at most @p budget, starting one if idle.
+     *
+     * Works whether or not incremental mode is enabled; gc_collect() completes
+     * an unfinished cycle.
+     *
+     * @return true once the cycle has completed.
+     */
+    bool gc_step(std::chrono::microseconds budget);
+
+    /**
+     * @brief Number of threads that mark during a stop-the-world collection.
+     *
+     * 1 (the default) marks on the collecting thread alone; 0 means one per
+     * hardware thread.  Helper threads are started on first use and parked
+     * between collections.  Small heaps are always marked serially.
+     */
+    void gc_set_mark_workers(unsigned n);
+
+    /// Settings for the background collector thread.
+    struct background_config {
+        std::chrono::milliseconds period{ 0 };            ///< also collect this often if anything was allocated (0: never)
+        long                      pressure_limit{ 16l << 20 }; ///< bytes allocated past the trigger before New waits for the collector
+    };
+
+    /**
+     * @brief Move automatic collections onto a dedicated thread.
+     *
+     * Allocating threads that run gc_counter out only wake the collector,
+     * which then runs marking and sweeps the whole heap, destructors included,
+     * ahead of the allocators.  They block only once
+     * another `pressure_limit` bytes have been allocated without a completed
+     * collection.  Calling it again while running just updates the settings.
+     */
+    void start_background_collector(const background_config& config = {});
+
+    /// Stop the collector thread; automatic collections run inline again.
+    void stop_background_collector();
+
+    /// Settings for deferred finalization.
+    struct finalizer_config {
+        bool     deferred{ false };   ///< queue dead objects instead of destroying them during the sweep
+        unsigned threads{ 0 };        ///< finalizer threads draining the queue (0: only run_finalizers() does)
+    };
+
+    /**
+     * @brief Take destructors off the threads that collect and sweep.
+     *
+     * While deferred, a dead object whose type has a destructor is put on a
+     * queue instead of being destroyed where the sweep meets it; its memory
+     * is freed once the destructor has run, on a finalizer thread or in
+     * run_finalizers().  Types that specialise gc_finalize_inline are still
+     * destroyed during the sweep, and so are the objects of a Heap or a
+     * Region.  gc_collect() returns with the queue possibly non-empty; it is
+     * drained at program exit.  Calling it again updates the settings: extra
+     * threads exit after their current batch, and objects queued before
+     * deferral was switched off are still left to the queue.
+     */
+    void gc_set_finalizers(const finalizer_config& config);
+
+    /**
+     * @brief Run queued finalizers on the calling thread for about @p budget.
+     *
+     * Works in batches, at least one if anything is queued; must not be
+     * called from a destructor of a managed object.
+     *
+     * @return the number of objects destroyed and freed.
+     */
+    std::size_t run_finalizers(std::chrono::microseconds budget = std::chrono::microseconds::max());
+
+    // ─────────────────────────────────────────────────────────────────────────────
+    // Untyped blocks
+    // ─────────────────────────────────────────────────────────────────────────────
+
+    /**
+     * @brief Allocate @p bytes of raw memory on the collected heap; backs the C API.
+     *
+     * The block is a root until gc_free_untyped().  It is traced
+     * conservatively: every aligned word in it that points into a block of
+     * the same heap keeps that block alive, so a freed block that another one
+     * still points at is not reclaimed.  Untyped blocks, and whatever they
+     * point at, are never moved by gc_compact(); in generational mode they
+     * stay in the nursery, as their stores pass no write barrier.  For the
+     * same reason an incremental or background mark may miss a pointer
+     * stored into one meanwhile, which only matters for freed blocks.
+     *
+     * @p zeroed clears the block; a large one comes zeroed from fresh pages.
+     * Aligned to 16 bytes.  Throws std::bad_alloc.
+     */
+    [[nodiscard]] void* gc_allocate_untyped(std::size_t bytes, bool zeroed = false);
+
+    /**
+     * @brief Drop the root of a block from gc_allocate_untyped().
+     *
+     * It is reclaimed by a later collection.  nullptr is ignored; returns
+     * false if @p p is not the start of a rooted untyped block.
+     */
+    bool gc_free_untyped(void* p) noexcept;
+
+    /**
+     * @brief Find roots on the thread stacks as well, from now on.
+     *
+     * Every collection of the default heap then stops the registered threads
+     * for as long as it marks, and treats each aligned word on their stacks,
+     * and in their saved registers, that points into a block as a root.  The
+     * raw pointers of C code keep its blocks alive this way, so untyped
+     * blocks are no longer rooted until gc_free_untyped(), and so do the
+     * pointers that C++ code takes out of a Ptr<>.  Words are matched through
+     * the arena's page map, interior pointers included.  Blocks named from a
+     * stack are never moved, and incremental cycles give way to
+     * stop-the-world collections, marked on the collecting thread alone.  It
+     * cannot be switched off again.
+     *
+     * A thread is registered by its first allocation or Ptr<> root, or by
+     * gc_register_thread().  POSIX only: threads are stopped with the signals
+     * GC_SUSPEND_SIGNAL and GC_RESUME_SIGNAL (SIGPWR and SIGXCPU on Linux,
+     * SIGXCPU and SIGXFSZ elsewhere), which the program must leave alone.
+     *
+     * @return false where stack scanning is not supported.
+     */
+    bool gc_enable_stack_scanning();
+
+    /// Make the calling thread's stack visible to stack scanning before it first allocates.
+    void gc_register_thread();
+
+    // ─────────────────────────────────────────────────────────────────────────────
+    // Heaps
+    // ─────────────────────────────────────────────────────────────────────────────
+
+    /**
+     * @brief A garbage-collected heap of its own, besides the default one.
+     *
+     * Owns its arena, lock, trigger and collector: collecting or destroying it
+     * never waits for the default heap or for another Heap, and vice versa.
+     * GC::New allocates into it inside a heap_scope.
+     *
+     * A heap traces its own objects only.  A pointer from one heap into
+     * another does not keep its target alive; roots do, wherever they are.
+     * A Heap always collects in a single pause and sweeps right after it;
+     * the generational, incremental and background modes, the parallel
+     * markers and gc_stats() concern the default heap only.
+     */
+    class Heap {
+    public:
+        explicit Heap(const heap_config& config = {});
+
+        /// Run the destructor of every object still in the heap and unmap it, without tracing.
+        ~Heap();
+
+        Heap(const Heap&) = delete;
+        Heap& operator=(const Heap&) = delete;
+
+        /// Collect this heap; unreachable objects are destroyed before it returns.
+        void collect();
+
+        /// Change the trigger of automatic collections of this heap; see gc_set_heap().
+        void set_config(const heap_config& config);
+
+    private:
+        friend class heap_scope;
+        std::unique_ptr<gc_heap_state> state_;
+    };
+
+    /// Make GC::New on this thread allocate into @p heap until the scope ends.  Scopes nest.
+    class heap_scope {
+    public:
+        explicit heap_scope(Heap& heap) noexcept : saved_(current_heap) { current_heap = heap.state_.get(); }
+        ~heap_scope() { current_heap = saved_; }
+
+        heap_scope(const heap_scope&) = delete;
+        heap_scope& operator=(const heap_scope&) = delete;
+
+    private:
+        gc_heap_state* saved_;
+    };
+
+    /**
+     * @brief Scope in which GC::New on this thread bump-allocates into a throwaway heap.
+     *
+     * Nothing in a region is traced or collected.  When it ends, every object
+     * allocated in it is destroyed (trivially destructible ones are skipped)
+     * and its chunks are unmapped, at a cost proportional to the pages used;
+     * nothing may refer into it any more by then.  With @p check_escapes the
+     * destructor first walks the region and calls std::terminate() if a Ptr
+     * root or a Local still refers to one of its objects.  A Region belongs
+     * to the thread that created it; regions and heap scopes nest.
+     */
+    class Region {
+    public:
+        explicit Region(bool check_escapes = false);
+        ~Region();
+
+        Region(const Region&) = delete;
+        Region& operator=(const Region&) = delete;
+
+    private:
+        std::unique_ptr<gc_heap_state> state_;
+        gc_heap_state*                 saved_;
+        bool                           check_escapes_;
+    };
+
+    // ─────────────────────────────────────────────────────────────────────────────
+    // Statistics
+    // ─────────────────────────────────────────────────────────────────────────────
+
+    /// What a collection_record describes.
+    enum class collection_kind : std::uint8_t {
+        full,    ///< stop-the-world full collection
+        minor,   ///< nursery collection (generational mode)
+        slice,   ///< one slice of an incremental cycle
+    };
+
+    /// One collection, or one slice of an incremental cycle.
+    struct collection_record {
+        collection_kind                       kind{ collection_kind::full };
+        bool                                  completed{ true };      ///< marking finished (false for an unfinished slice)
+        std::chrono::steady_clock::time_point start{};
+        std::chrono::nanoseconds              pause{ 0 };             ///< time spent holding gc_mutex
+        std::chrono::nanoseconds              destroy{ 0 };           ///< destructors run by the collecting thread afterwards
+        std::size_t                           marked_objects{ 0 };    ///< survivors (of the nursery, for a minor collection)
+        std::size_t                           marked_bytes{ 0 };
+        std::size_t                           freed_objects{ 0 };     ///< found unreachable; most are swept lazily
+        std::size_t                           freed_bytes{ 0 };
+    };
+
+    inline constexpr std::size_t gc_pause_buckets  = 24;   ///< bucket i counts pauses under 2^i µs not counted before; the last one the rest
+    inline constexpr std::size_t gc_history_length = 64;   ///< collection_records kept
+
+    /// Counters since program start, as returned by gc_stats().
+    struct heap_stats {
+        std::uint64_t            collections{ 0 };        ///< full and minor collections, and completed incremental cycles
+        std::uint64_t            minor_collections{ 0 };
+        std::uint64_t            slices{ 0 };             ///< incremental slices, completed or not
+        std::uint64_t            allocated_objects{ 0 };  ///< by every thread, the exited ones included
+        std::uint64_t            allocated_bytes{ 0 };    ///< headers included
+        std::uint64_t            root_slow_paths{ 0 };    ///< root count increments that had to take gc_mutex
+        std::uint64_t            freed_objects{ 0 };
+        std::uint64_t            freed_bytes{ 0 };
+        std::chrono::nanoseconds total_pause{ 0 };
+        std::chrono::nanoseconds max_pause{ 0 };
+        std::chrono::nanoseconds total_destroy{ 0 };
+        std::array<std::uint64_t, gc_pause_buckets> pause_histogram{};
+        std::vector<collection_record>              history;   ///< oldest first
+    };
+
+    /**
+     * @brief Snapshot of the collector statistics.
+     *
+     * Allocation counters live in each thread and are summed here, so the
+     * allocation path never writes to shared memory for them.  Does not wait
+     * for a collection in progress.
+     */
+    [[nodiscard]] heap_stats gc_stats();
+
+    /// Hooks run around every collection and incremental slice, on the collecting thread.
+    struct collection_callbacks {
+        std::function<void()>                         on_start;   ///< before gc_mutex is taken
+        std::function<void(const collection_record&)> on_end;     ///< once the collection's own destructors have run
+    };
+
+    /**
+     * @brief Install collection hooks, replacing any installed before.
+     *
+     * They run with no collector lock held and may allocate; a collection
+     * started from a hook does not run the hooks again.
+     */
+    void gc_set_callbacks(collection_callbacks callbacks);
+
+    // ─────────────────────────────────────────────────────────────────────────────
+    // Type descriptors
+    // ─────────────────────────────────────────────────────────────────────────────
+
+    /// What the collector needs to know about a managed type, shared by all its objects.
+    struct gc_type {
+        void (*destroy)(std::byte* s, std::byte* e) noexcept;   ///< destroys the elements in [s, e); nullptr if trivial
+        std::size_t size;                                        ///< sizeof one element
+        bool mapped{ false };                                    ///< traced through `pointers`, not gc_object::first
+        std::span<const std::size_t> pointers{};                 ///< offsets of the Ptr<> members in one element
+        bool finalize_inline{ false };                           ///< never deferred; see gc_finalize_inline
+        bool pinned{ false };                                    ///< never moved; see gc_pinned
+        bool conservative{ false };                              ///< every payload word may point into the heap; see gc_allocate_untyped
+    };
+
+    /**
+     * @brief Opt-out of deferred finalization; see gc_set_finalizers().
+     *
+     * Specialise it as std::true_type for a T whose destructor must run on
+     * the thread that sweeps it, during the sweep:
+     *
+     *     template <> struct GC::gc_finalize_inline<Session> : std::true_type {};
+     */
+    template <typename T>
+    struct gc_finalize_inline : std::false_type {};
+
+    /**
+     * @brief Opt-out of compaction; see gc_compact().
+     *
+     * gc_compact() moves an object with memcpy and then fixes up its Ptr<>
+     * members only.  Specialise it as std::true_type for a T that holds, or
+     * hands out, a pointer into itself, such as a std::string with its
+     * characters stored inline:
+     *
+     *     template <> struct GC::gc_pinned<Label> : std::true_type {};
+     */
+    template <typename T>
+    struct gc_pinned : std::false_type {};
+
+    /**
+     * @brief Opt-in to parallel construction of large arrays; see New<T[]>.
+     *
+     * Specialise it as std::true_type for a T whose default constructor may
+     * run on several threads at once, in no particular order.  Only honoured
+     * for a T without linked Ptr<> members, that is a trivially destructible
+     * T or one with a gc_pointer_map.
+     */
+    template <typename T>
+    struct gc_parallel_construct : std::false_type {};
+
+    /**
+     * @brief Opt-in layout descriptor: where the Ptr<> members of T live.
+     *
+     * Specialise it with a tuple `members` of pointers to every Ptr<> member
+     * of T, for instance
+     *
+     *     template <> struct GC::gc_pointer_map<Node> {
+     *         static constexpr auto members = std::make_tuple(&Node::next, &Node::prev);
+     *     };
+     *
+     * Marking then reads those slots straight out of the payload instead of
+     * following the per-object list of heap pointers, and the members are
+     * not linked into that list.  A Ptr<> member missing from the map is not
+     * traced at all, so the map must be complete.
+     */
+    template <typename T>
+    struct gc_pointer_map {};
+
+    template <typename T>
+    concept GcPointerMapped = requires {
+        std::tuple_size<std::remove_cvref_t<decltype(gc_pointer_map<T>::members)>>::value;
+    };
+
+    /// Byte offsets of the members listed in gc_pointer_map<T>.
+    template <GcPointerMapped T>
+    [[nodiscard]] const auto& gc_pointer_offsets()
+    {
+        static const auto offsets = std::apply([](auto... member) {
+            static_assert((std::derived_from<std::remove_cvref_t<decltype(std::declval<T&>().*member)>, gc_base_ptr> && ...),
+                "gc_pointer_map may only list Ptr<> members");
+
+            // Member addresses only: the probe never holds a T.
+            alignas(T) static std::byte probe[sizeof(T)];
+            [[maybe_unused]] const auto* t = reinterpret_cast<const T*>(probe);   // unused for an empty map
+            return std::array<std::size_t, sizeof...(member)>{ static_cast<std::size_t>(
+                reinterpret_cast<const std::byte*>(std::addressof(t->*member)) - probe)... };
+        }, gc_pointer_map<T>::members);
+        return offsets;
+    }
+
+    inline constexpr std::size_t gc_max_types = std::size_t{ 1 } << 16;
+
+    extern std::array<const gc_type*, gc_max_types> gc_types;   ///< indexed by gc_object::type
+
+    /// Add @p type to gc_types; throws std::length_error once the table is full.
+    std::uint16_t gc_register_type(const gc_type& type);
+
+    /**
+     * @brief Index of T's descriptor, registered on first use.
+     *
+     * A trivially destructible T gets no destroy function: the sweep then
+     * frees its dead objects without reading them.  Such a T cannot hold a
+     * Ptr<>, whose destructor is not trivial.
+     */
+    template <GcManaged T>
+    [[nodiscard]] std::uint16_t gc_type_index()
+    {
+        using destroy_fn = void (*)(std::byte*, std::byte*) noexcept;
+        static constexpr destroy_fn destroy = std::is_trivially_destructible_v<T>
+            ? nullptr
+            : +[](std::byte* s, std::byte* e) noexcept {
+                // Destroy in reverse order (matches construction order).
+                std::destroy(std::make_reverse_iterator(reinterpret_cast<T*>(e)),
+                    std::make_reverse_iterator(reinterpret_cast<T*>(s)));
+            };
+        static const gc_type type = [] {
+            gc_type t{ destroy, sizeof(T) };
+            if constexpr (GcPointerMapped<T>) {
+                t.mapped = true;
+                t.pointers = gc_pointer_offsets<T>();
+            }
+            t.finalize_inline = gc_finalize_inline<T>::value;
+            t.pinned = gc_pinned<T>::value;
+            return t;
+        }();
+        static const std::uint16_t index = gc_register_type(type);
+        return index;
+    }
+
     // ─────────────────────────────────────────────────────────────────────────────
     // gc_object
     // ─────────────────────────────────────────────────────────────────────────────
@@ -55,59 +578,293 @@ namespace GC {
     /**
      * @brief GC control block.
      *
-     * Memory layout: [gc_object][C++ object(s)...]
+     * Memory layout: [gc_object][C++ object]                 single object
+     *                [gc_object][count][pad][C++ objects...] array
      *
-     * destructor callback receives a std::span<std::byte> that covers
-     * exactly the managed objects, making the size implicit and avoiding manual
-     * pointer casting at each call site.
+     * Sixteen bytes, so the payload is 16-byte aligned.  The size and the
+     * destructor come from the type descriptor; the mark bit lives in the
+     * chunk's bitmap, so marking does not write to the object.  Whether the
+     * object needs destroying at all is recorded in a chunk bitmap too.
      */
 
     class gc_object {
         template <GcManaged T> friend class New;
+        template <GcManaged T> friend class New_batch;
         friend class gc_base_ptr;
-        friend void gc_collect();
+        friend class gc_thread;
+        friend class gc_collector;
 
         gc_object(const gc_object&) = delete;
         gc_object& operator=(const gc_object&) = delete;
 
     protected:
-        void* end_;   ///< one-past-end of the managed region
+        std::atomic<gc_base_ptr*> first{ nullptr };
+        std::atomic<int>          root_ref_cnt{ 0 };
+        std::uint16_t             type;                 ///< index into gc_types
+        std::uint8_t              age{ 0 };             ///< minor collections survived
+        bool                      array : 1;            ///< preceded by an element count
+        bool                      old : 1 { false };    ///< promoted out of the nursery
+        bool                      remembered : 1 { false };  ///< listed in the remembered set
 
-        [[nodiscard]] void* start() noexcept { return static_cast<void*>(this + 1); }
-        [[nodiscard]] void* end()   noexcept { return end_; }
+        /// Bytes between the header and the first element of an array.
+        static constexpr std::size_t array_cookie = 16;
 
-        /// Destructor callback – receives [start, end) of the managed region.
-        void (*destructor)(std::byte* s, std::byte* e) noexcept;
+        [[nodiscard]] void* start() noexcept
+        {
+            return reinterpret_cast<char*>(this + 1) + (array ? array_cookie : 0);
+        }
+        [[nodiscard]] std::size_t count() noexcept
+        {
+            return array ? *reinterpret_cast<std::size_t*>(this + 1) : 1;
+        }
+        [[nodiscard]] void* end() noexcept
+        {
+            return static_cast<char*>(start()) + count() * gc_types[type]->size;
+        }
 
-        std::atomic<int>          root_ref_cnt{ 0 };
-        std::atomic<gc_base_ptr*> first{ nullptr };
-        bool                      mark{ false };
+        [[nodiscard]] bool marked() const noexcept { return gc_marked(this); }
+        void set_marked(bool m) noexcept { gc_set_marked(this, m); }
+        [[nodiscard]] bool test_and_mark() noexcept { return gc_test_and_mark(this); }
 
     public:
-        gc_object() noexcept;
-        gc_object(void* e, void (*d)(std::byte*, std::byte*) noexcept) noexcept;
+        /// @p count is the element count of an array, or npos for a single object.
+        gc_object(std::uint16_t type, std::size_t count) noexcept;
         ~gc_object();
+
+        static constexpr std::size_t npos = static_cast<std::size_t>(-1);
+
+        /// Header-plus-cookie bytes in front of the payload.
+        static constexpr std::size_t overhead(bool is_array) noexcept
+        {
+            return sizeof(gc_object) + (is_array ? array_cookie : 0);
+        }
+    };
+
+    static_assert(sizeof(gc_object) == 16);
+
+    // ─────────────────────────────────────────────────────────────────────────────
+    // gc_thread
+    // ─────────────────────────────────────────────────────────────────────────────
+
+    /**
+     * @brief Per-thread shadow stack holding the objects of Local<> roots.
+     *
+     * Only its thread writes it, with plain relaxed stores; the collector
+     * reads every slot below `top` when it seeds.  The array is never
+     * reallocated, so that read is safe at any time.  A released slot is
+     * nulled before `top` moves down past it, so everything the collector
+     * can see was rooted while the current collection ran.
+     */
+    struct gc_local_slots {
+        static constexpr std::size_t capacity = 4096;
+
+        std::unique_ptr<std::atomic<gc_object*>[]> slots;   ///< allocated on first use
+        std::atomic<std::size_t>                    top{ 0 };
+
+        /// A free slot, or nullptr once all are taken.
+        [[nodiscard]] std::atomic<gc_object*>* push()
+        {
+            const std::size_t n = top.load(std::memory_order_relaxed);
+            if (n == capacity)
+                return nullptr;
+            if (!slots)
+                slots = std::make_unique<std::atomic<gc_object*>[]>(capacity);
+            top.store(n + 1, std::memory_order_release);   // publishes `slots` to the collector
+            return &slots[n];
+        }
+
+        /// Release @p slot; out-of-order releases are reclaimed once the slots above are.
+        void pop(std::atomic<gc_object*>* slot) noexcept
+        {
+            slot->store(nullptr, std::memory_order_relaxed);
+            std::size_t n = top.load(std::memory_order_relaxed);
+            if (&slots[n - 1] != slot)
+                return;
+            do {
+                --n;
+            } while (n != 0 && slots[n - 1].load(std::memory_order_relaxed) == nullptr);
+            top.store(n, std::memory_order_relaxed);
+        }
+    };
+
+    /**
+     * @brief Per-thread allocation state: cell cache, young list and GC credits.
+     *
+     * The steady-state New path touches nothing but this record: the cell comes
+     * from a private gc_cell_cache and the new object is appended to the
+     * thread's young list.  gc_collect() takes the young lists over in one batch
+     * after waiting for every thread to leave its allocation critical section,
+     * signalled through `allocating_`.  A thread that finds a collection in
+     * progress falls back to allocating under gc_mutex.  The cell is taken
+     * before either, since refilling the cache may sweep and run destructors.
+     */
+    class gc_thread {
+        friend class gc_collector;
+        template <typename T> friend class Local;
+
+    public:
+        /**
+         * @brief Allocate and register a gc_object spanning @p bytes (header included).
+         *
+         * @p count is forwarded to the gc_object constructor.
+         */
+        [[nodiscard]] static gc_object* allocate(std::size_t bytes, std::uint16_t type, std::size_t count, bool root);
+
+        /**
+         * @brief allocate() for out.size() single objects of @p bytes each, all roots.
+         *
+         * Charges the trigger once, takes the cells from the arena a batch per
+         * lock and registers every object in one step.
+         */
+        static void allocate_batch(std::size_t bytes, std::uint16_t type, std::span<gc_object*> out);
+
+        /// Let objects whose constructors never ran, or threw, be collected without destroying them.
+        static void abandon_batch(std::span<gc_object* const> objects) noexcept;
+
+        gc_thread(const gc_thread&) = delete;
+        gc_thread& operator=(const gc_thread&) = delete;
+
+    private:
+        /// Bytes a thread may allocate before settling up with gc_counter.
+        static constexpr long credit_batch = 8 * 1024;
+
+        /// Statistics written by the owning thread only, summed by gc_stats().
+        struct counters {
+            std::atomic<std::uint64_t> allocated_objects{ 0 };
+            std::atomic<std::uint64_t> allocated_bytes{ 0 };
+            std::atomic<std::uint64_t> root_slow_paths{ 0 };
+        };
+
+        /// Single-writer increment: no read-modify-write needed.
+        static void bump(std::atomic<std::uint64_t>& c, std::uint64_t n) noexcept
+        {
+            c.store(c.load(std::memory_order_relaxed) + n, std::memory_order_relaxed);
+        }
+
+        std::atomic<bool>       allocating_{ false };
+        long                    credits_{ 0 };
+        counters                counters_;
+        gc_local_slots          locals_;
+        gc_cell_cache           cells_;
+        std::vector<gc_object*> young_;
+        gc_thread*              next_{ nullptr };      ///< registry link
+        struct stack_range;
+        stack_range*            stack_{ nullptr };     ///< what a stack scan reads; see gc_enable_stack_scanning()
+
+        gc_thread() = default;
+        ~gc_thread() = default;
+
+        friend struct gc_thread_exit;
+
+        /// Register the calling thread; nullptr once it is shutting down.
+        static gc_thread* attach();
+        static void detach() noexcept;
+
+        /// Spend @p bytes of allocation credit, topping up from gc_counter when out.
+        static void charge(gc_thread* t, std::size_t bytes)
+        {
+            const long n = static_cast<long>(bytes);
+            if (t != nullptr && t->credits_ >= n) {
+                t->credits_ -= n;
+                return;
+            }
+            settle(t, n);
+        }
+
+        static void settle(gc_thread* t, long bytes);
+        static void count_detached(std::size_t bytes) noexcept;
+        static gc_object* allocate_in(gc_heap_state* h, std::size_t bytes, std::uint16_t type, std::size_t count, bool root);
+
+        /// A shadow-stack slot of the calling thread, or nullptr if none can be had.
+        static std::atomic<gc_object*>* push_local() noexcept;
+        static void pop_local(std::atomic<gc_object*>* slot) noexcept { current_thread->locals_.pop(slot); }
+
+        /// Called after a non-null store into a slot; see gc_roots_locked.
+        static void local_barrier(gc_object* o) noexcept
+        {
+            gc_light_fence();
+            if (gc_roots_locked.load(std::memory_order_relaxed) != 0)
+                local_barrier_slow(o);
+        }
+
+        static void local_barrier_slow(gc_object* o) noexcept;
+        static gc_object* allocate_locked(void* mem, std::uint16_t type, std::size_t count, bool root);
+
+        [[nodiscard]] bool enter() noexcept
+        {
+            allocating_.store(true, std::memory_order_relaxed);
+            gc_light_fence();
+            if (!gc_collecting.load(std::memory_order_relaxed))
+                return true;
+            allocating_.store(false, std::memory_order_release);
+            return false;
+        }
+
+        void leave() noexcept { allocating_.store(false, std::memory_order_release); }
     };
 
+    inline gc_object* gc_thread::allocate(std::size_t bytes, std::uint16_t type, std::size_t count, bool root)
+    {
+        if (current_heap != nullptr)
+            return allocate_in(current_heap, bytes, type, count, root);
+
+        gc_thread* t = current_thread ? current_thread : attach();
+        charge(t, bytes);
+        if (t != nullptr) {
+            bump(t->counters_.allocated_objects, 1);
+            bump(t->counters_.allocated_bytes, bytes);
+        }
+        else {
+            count_detached(bytes);
+        }
+
+        void* mem = t ? t->cells_.allocate(bytes) : arena.allocate(bytes);
+        if (t == nullptr || !t->enter())
+            return allocate_locked(mem, type, count, root);
+
+        struct leave_guard {
+            gc_thread* t;
+            ~leave_guard() { t->leave(); }
+        } guard{ t };
+
+        try {
+            t->young_.push_back(nullptr);
+        }
+        catch (...) {
+            arena.deallocate(mem);
+            throw;
+        }
+
+        auto* o = ::new (mem) gc_object(type, count);
+        if (root)
+            o->root_ref_cnt.store(1, std::memory_order_relaxed);
+        t->young_.back() = o;
+        return o;
+    }
+
     // ─────────────────────────────────────────────────────────────────────────────
     // gc_base_ptr
     // ─────────────────────────────────────────────────────────────────────────────
 
     class gc_base_ptr {
-        friend void gc_collect();
+        friend class gc_collector;
         static void gc_collect(gc_object* o);
 
     protected:
+        template <typename T> friend class Local;
+
         enum class PtrType : std::uint8_t { ROOT, GC_HEAP };
 
         PtrType                   type;
         std::atomic<gc_base_ptr*> next{ nullptr };
         std::atomic<gc_object*>   object{ nullptr };
 
-        /// Increment root_ref_cnt, acquiring the mutex only when necessary.
+        /// Increment root_ref_cnt; takes the mutex only for a 0 → 1 step while the collector reads root counts.
         static void inc_root(gc_object* o) noexcept;
         /// Decrement root_ref_cnt (never needs the mutex).
         static void dec_root(gc_object* o) noexcept;
+        /// Generational write barrier for a store into @p owner, taking the mutex.
+        static void remember(gc_object* owner, gc_object* target);
 
     public:
         explicit gc_base_ptr(gc_object* c = nullptr);
@@ -137,6 +894,11 @@ namespace GC {
     template <GcManaged T>
     class Ptr : public gc_base_ptr {
         template <GcManaged U> friend class Ptr;
+        template <GcManaged U> friend class New_batch;
+        template <typename U> friend class Local;
+
+        /// Root to @p o, exposing @p p; see Local<T>::operator Ptr<T>.
+        Ptr(gc_object* o, T* p) : gc_base_ptr(o) { ptr = p; }
 
     protected:
         T* ptr{ nullptr };
@@ -201,10 +963,145 @@ namespace GC {
         template <std::integral U> Ptr& operator-=(U z) noexcept { ptr -= z; return *this; }
     };
 
+    // ─────────────────────────────────────────────────────────────────────────────
+    // Local<T>
+    // ─────────────────────────────────────────────────────────────────────────────
+
+    /**
+     * @brief Scoped root kept in a per-thread shadow stack instead of root_ref_cnt.
+     *
+     * Copying, assigning and destroying a Local<> never writes to the target's
+     * header: the object goes into a gc_local_slots slot with a plain store,
+     * so threads that read the same objects do not contend on them.  While
+     * the collector reads roots, a non-null store takes gc_mutex just like a
+     * root count going 0 → 1.
+     *
+     * A Local<> must be an automatic variable (or temporary) of the thread
+     * that created it: not a member of a managed object, not a global, not
+     * handed to another thread.  Once a thread's slots run out, further
+     * Locals fall back to counting, like a root Ptr<>.
+     */
+    template <typename T>
+    class Local {
+        static_assert(GcManaged<T>);
+        template <typename U> friend class Local;
+
+        std::atomic<gc_object*>* slot_;                 ///< nullptr: counted in root_ref_cnt instead
+        gc_object*               object_{ nullptr };
+        T*                       ptr_{ nullptr };
+
+        void set(gc_object* o, T* p) noexcept
+        {
+            if (slot_ != nullptr) {
+                slot_->store(o, std::memory_order_relaxed);
+                if (o != nullptr)
+                    gc_thread::local_barrier(o);
+            }
+            else {
+                if (o != nullptr)
+                    gc_base_ptr::inc_root(o);
+                if (object_ != nullptr)
+                    gc_base_ptr::dec_root(object_);
+            }
+            object_ = o;
+            ptr_ = p;
+        }
+
+    public:
+        // ── Constructors ─────────────────────────────────────────────────────────
+
+        Local() noexcept : slot_(gc_thread::push_local()) {}
+        Local(std::nullptr_t) noexcept : Local() {}
+
+        template <GcManaged U>
+            requires std::convertible_to<U*, T*>
+        Local(const Ptr<U>& o) noexcept : Local() { set(o.object.load(std::memory_order_relaxed), o.get()); }
+
+        Local(const Local& o) noexcept : Local() { set(o.object_, o.ptr_); }
+
+        template <typename U>
+            requires std::convertible_to<U*, T*>
+        Local(const Local<U>& o) noexcept : Local() { set(o.object_, o.ptr_); }
+
+        /// Takes over the slot (or the count) of @p o.
+        Local(Local&& o) noexcept : slot_(o.slot_), object_(o.object_), ptr_(o.ptr_)
+        {
+            o.slot_ = nullptr;
+            o.object_ = nullptr;
+            o.ptr_ = nullptr;
+        }
+
+        ~Local()
+        {
+            if (slot_ != nullptr)
+                gc_thread::pop_local(slot_);
+            else if (object_ != nullptr)
+                gc_base_ptr::dec_root(object_);
+        }
+
+        // ── Assignment ───────────────────────────────────────────────────────────
+
+        Local& operator=(const Local& o) noexcept { set(o.object_, o.ptr_); return *this; }
+        Local& operator=(Local&& o) noexcept
+        {
+            if (this != &o) {
+                set(o.object_, o.ptr_);
+                o.set(nullptr, nullptr);
+            }
+            return *this;
+        }
+        Local& operator=(std::nullptr_t) noexcept { set(nullptr, nullptr); return *this; }
+
+        template <GcManaged U>
+            requires std::convertible_to<U*, T*>
+        Local& operator=(const Ptr<U>& o) noexcept
+        {
+            set(o.object.load(std::memory_order_relaxed), o.get());
+            return *this;
+        }
+
+        // ── Observers ────────────────────────────────────────────────────────────
+
+        [[nodiscard]] T* get()          const noexcept { return ptr_; }
+        [[nodiscard]] explicit operator bool() const noexcept { return ptr_ != nullptr; }
+        T& operator*()  const noexcept { return *ptr_; }
+        T* operator->() const noexcept { return ptr_; }
+        T& operator[](std::ptrdiff_t idx) const noexcept { return ptr_[idx]; }
+
+        /// A counted root (or, inside a constructor, heap pointer) to the same object.
+        operator Ptr<T>() const { return Ptr<T>(object_, ptr_); }
+
+        void reset() noexcept { set(nullptr, nullptr); }
+    };
+
+    template <typename T, typename U>
+    [[nodiscard]] bool operator==(const Local<T>& a, const Local<U>& b) noexcept
+    {
+        return a.get() == b.get();
+    }
+
+    template <typename T, GcManaged U>
+    [[nodiscard]] bool operator==(const Local<T>& a, const Ptr<U>& b) noexcept
+    {
+        return a.get() == b.get();
+    }
+
+    template <typename T>
+    [[nodiscard]] bool operator==(const Local<T>& a, std::nullptr_t) noexcept
+    {
+        return a.get() == nullptr;
+    }
+
     // ─────────────────────────────────────────────────────────────────────────────
     // New<T>  – single object
     // ─────────────────────────────────────────────────────────────────────────────
 
+    /// Selects default- rather than value-initialization; see New_for_overwrite.
+    struct gc_default_init_t {
+        explicit gc_default_init_t() = default;
+    };
+    inline constexpr gc_default_init_t gc_default_init{};
+
     template <GcManaged T>
     class New : public Ptr<T> {
     public:
@@ -212,49 +1109,42 @@ namespace GC {
             requires std::constructible_from<T, Args...>
         explicit New(Args&&... args)
         {
-            auto* mem = static_cast<char*>(::operator new(sizeof(gc_object) + sizeof(T)));
-
-            gc_object* new_obj = nullptr;
-            {
-                std::scoped_lock lock{ gc_mutex };
-
-                if (gc_counter.fetch_sub(1, std::memory_order_relaxed) <= 0) {
-                    // Release the lock before collecting to avoid deadlock.
-                    // Unlock manually here since scoped_lock doesn't support that.
-                }
-                // Re-check after potential collection below
-            }
-
-            // Trigger collection outside the lock if the counter expired.
-            if (gc_counter.load(std::memory_order_relaxed) < 0) {
-                gc_collect();
-            }
-
-            {
-                std::scoped_lock lock{ gc_mutex };
-                new_obj = new (mem) gc_object(
-                    mem + sizeof(gc_object) + sizeof(T),
-                    [](std::byte* s, std::byte* /*e*/) noexcept {
-                        std::destroy_at(reinterpret_cast<T*>(s));
-                    });
+            build([&](T* p) { std::construct_at(p, std::forward<Args>(args)...); });
+        }
 
-                gc_base_ptr::object.store(new_obj, std::memory_order_relaxed);
-                if (gc_base_ptr::type == gc_base_ptr::PtrType::ROOT)
-                    new_obj->root_ref_cnt.store(1, std::memory_order_relaxed);
+        explicit New(gc_default_init_t)
+            requires std::default_initializable<T>
+        {
+            build([](T* p) { ::new (static_cast<void*>(p)) T; });
+        }
 
-                all_objects.push_back(new_obj);
-            }
+    private:
+        template <typename F>
+        void build(F&& construct)
+        {
+            // Registered up front, so that abandon_batch() cannot throw.
+            static_cast<void>(gc_type_index<std::byte>());
+            gc_object* new_obj = gc_thread::allocate(
+                gc_object::overhead(false) + sizeof(T),
+                gc_type_index<T>(),
+                gc_object::npos,
+                gc_base_ptr::type == gc_base_ptr::PtrType::ROOT);
+
+            gc_base_ptr::object.store(new_obj, std::memory_order_relaxed);
+            // The parent may have been promoted by a collection this allocation triggered.
+            if (gc_base_ptr::type == gc_base_ptr::PtrType::GC_HEAP && current->old)
+                gc_base_ptr::remember(current, new_obj);
 
             gc_object* parent = current;
             current = new_obj;
             Ptr<T>::ptr = static_cast<T*>(new_obj->start());
 
             try {
-                std::construct_at(static_cast<T*>(new_obj->start()), std::forward<Args>(args)...);
+                construct(static_cast<T*>(new_obj->start()));
             }
             catch (...) {
-                if (gc_base_ptr::type == gc_base_ptr::PtrType::ROOT)
-                    new_obj->root_ref_cnt.fetch_sub(1, std::memory_order_relaxed);
+                // Retyped, so that the sweep does not run ~T over what was never built.
+                gc_thread::abandon_batch(std::span<gc_object* const>(&new_obj, 1));
                 gc_base_ptr::object.store(nullptr, std::memory_order_relaxed);
                 Ptr<T>::ptr = nullptr;
                 current = parent;
@@ -269,54 +1159,87 @@ namespace GC {
     // New<T[]>  – array of objects
     // ─────────────────────────────────────────────────────────────────────────────
 
+    /// Element bytes per thread below which New<T[]> does not split construction.
+    inline constexpr std::size_t gc_parallel_construct_min = std::size_t{ 1 } << 20;
+
+    /**
+     * @brief Threads to construct @p bytes of elements on, the caller included; 1: construct serially.
+     *
+     * Never more than the hardware threads, and always 1 inside a Region,
+     * which only its own thread may allocate from.
+     */
+    [[nodiscard]] std::size_t gc_construct_chunks(std::size_t bytes) noexcept;
+
+    /**
+     * @brief Run @p body(@p ctx, i) for each i in [0, @p chunks) and return once all are done.
+     *
+     * The chunks are shared between the caller and a pool of parked helper
+     * threads, which see the caller's `current` and `current_heap`: what they
+     * construct belongs to the same object and heap.  The pool serves one
+     * call at a time; a call that finds it busy, nested in a constructor or
+     * from another thread, runs every chunk on its caller.
+     */
+    void gc_run_chunks(std::size_t chunks, void (*body)(void* ctx, std::size_t chunk) noexcept, void* ctx);
+
+    /**
+     * @brief Allocate an array of @p size elements.
+     *
+     * A trivial T is zeroed, or left alone for a large block, which comes
+     * zeroed from fresh pages; with gc_default_init it is not written at
+     * all.  Beyond gc_parallel_construct_min bytes, the elements of a T that
+     * opts in through gc_parallel_construct are constructed in chunks on
+     * several threads.  If a constructor throws, the elements built so far
+     * are destroyed, the block is left to the collector without running
+     * any destructor again, and the first exception is rethrown.
+     */
     template <GcManaged T>
     class New<T[]> : public Ptr<T> {
     public:
         explicit New(std::size_t size)
             requires std::default_initializable<T>
         {
-            auto* mem = static_cast<char*>(::operator new(sizeof(gc_object) + size * sizeof(T)));
-
-            gc_object* new_obj = nullptr;
-
-            if (gc_counter.fetch_sub(1, std::memory_order_relaxed) <= 0)
-                gc_collect();
-
-            {
-                std::scoped_lock lock{ gc_mutex };
-                new_obj = new (mem) gc_object(
-                    mem + sizeof(gc_object) + size * sizeof(T),
-                    [](std::byte* s, std::byte* e) noexcept {
-                        // Destroy in reverse order (matches construction order).
-                        auto* end = reinterpret_cast<T*>(e);
-                        auto* begin = reinterpret_cast<T*>(s);
-                        std::destroy(std::make_reverse_iterator(end),
-                            std::make_reverse_iterator(begin));
-                    });
-
-                gc_base_ptr::object.store(new_obj, std::memory_order_relaxed);
-                if (gc_base_ptr::type == gc_base_ptr::PtrType::ROOT)
-                    new_obj->root_ref_cnt.store(1, std::memory_order_relaxed);
-
-                all_objects.push_back(new_obj);
-            }
+            build<true>(size);
+        }
+
+        New(std::size_t size, gc_default_init_t)
+            requires std::default_initializable<T>
+        {
+            build<false>(size);
+        }
+
+    private:
+        template <bool Value>
+        void build(std::size_t size)
+        {
+            if (size > (std::numeric_limits<std::size_t>::max() - gc_object::overhead(true)) / sizeof(T))
+                throw std::bad_array_new_length();
+            const std::size_t bytes = gc_object::overhead(true) + size * sizeof(T);
+
+            // Registered up front, so that abandon_batch() cannot throw.
+            static_cast<void>(gc_type_index<std::byte>());
+            gc_object* new_obj = gc_thread::allocate(
+                bytes,
+                gc_type_index<T>(),
+                size,
+                gc_base_ptr::type == gc_base_ptr::PtrType::ROOT);
+
+            gc_base_ptr::object.store(new_obj, std::memory_order_relaxed);
+            // The parent may have been promoted by a collection this allocation triggered.
+            if (gc_base_ptr::type == gc_base_ptr::PtrType::GC_HEAP && current->old)
+                gc_base_ptr::remember(current, new_obj);
 
             gc_object* parent = current;
             current = new_obj;
 
             T* begin = static_cast<T*>(new_obj->start());
-            T* end = static_cast<T*>(new_obj->end());
             Ptr<T>::ptr = begin;
 
-            T* constructed_end = begin;
             try {
-                for (T* i = begin; i != end; ++i, ++constructed_end)
-                    std::construct_at(i);
+                construct<Value>(begin, size, gc_large_block(bytes));
             }
             catch (...) {
-                std::destroy(begin, constructed_end);
-                if (gc_base_ptr::type == gc_base_ptr::PtrType::ROOT)
-                    new_obj->root_ref_cnt.fetch_sub(1, std::memory_order_relaxed);
+                // Retyped, so that the sweep does not run ~T over what was never built.
+                gc_thread::abandon_batch(std::span<gc_object* const>(&new_obj, 1));
                 gc_base_ptr::object.store(nullptr, std::memory_order_relaxed);
                 Ptr<T>::ptr = nullptr;
                 current = parent;
@@ -325,6 +1248,147 @@ namespace GC {
 
             current = parent;
         }
+
+        /// Elements [begin, begin + n); none is left constructed if one throws.
+        template <bool Value>
+        static void construct(T* begin, std::size_t n, bool zeroed)
+        {
+            if constexpr (std::is_trivially_default_constructible_v<T>) {
+                if (Value && !zeroed)
+                    std::memset(static_cast<void*>(begin), 0, n * sizeof(T));
+            }
+            else {
+                if constexpr (gc_parallel_construct<T>::value &&
+                              (std::is_trivially_destructible_v<T> || GcPointerMapped<T>)) {
+                    if (const std::size_t chunks = gc_construct_chunks(n * sizeof(T)); chunks > 1) {
+                        construct_parallel<Value>(begin, n, chunks);
+                        return;
+                    }
+                }
+                if constexpr (Value)
+                    std::uninitialized_value_construct_n(begin, n);
+                else
+                    std::uninitialized_default_construct_n(begin, n);
+            }
+        }
+
+        template <bool Value>
+        static void construct_parallel(T* begin, std::size_t n, std::size_t chunks)
+        {
+            struct job {
+                T*                                    begin;
+                std::size_t                           n;
+                std::size_t                           chunks;
+                std::unique_ptr<std::exception_ptr[]> errors;   ///< per chunk; null if it was built
+
+                [[nodiscard]] T* at(std::size_t chunk) const noexcept { return begin + n * chunk / chunks; }
+            };
+            job j{ begin, n, chunks, std::make_unique<std::exception_ptr[]>(chunks) };
+
+            gc_run_chunks(chunks, [](void* ctx, std::size_t chunk) noexcept {
+                const job& j = *static_cast<const job*>(ctx);
+                try {
+                    if constexpr (Value)
+                        std::uninitialized_value_construct(j.at(chunk), j.at(chunk + 1));
+                    else
+                        std::uninitialized_default_construct(j.at(chunk), j.at(chunk + 1));
+                }
+                catch (...) {
+                    j.errors[chunk] = std::current_exception();
+                }
+            }, &j);
+
+            std::exception_ptr error;
+            for (std::size_t c = 0; c != chunks && !error; ++c)
+                error = j.errors[c];
+            if (!error)
+                return;
+            for (std::size_t c = chunks; c-- != 0;) {
+                if (!j.errors[c])
+                    std::destroy(j.at(c), j.at(c + 1));
+            }
+            std::rethrow_exception(error);
+        }
+    };
+
+    // ─────────────────────────────────────────────────────────────────────────────
+    // New_for_overwrite<T>  – default-initialized objects
+    // ─────────────────────────────────────────────────────────────────────────────
+
+    /**
+     * @brief New<T> or New<T[]>, default- rather than value-initialized.
+     *
+     * For memory about to be overwritten: a trivial T is left as the
+     * allocator hands it over, zeroed for a large block, anything for a
+     * recycled cell, so not even its pages are touched.
+     */
+    template <GcManaged T>
+    class New_for_overwrite : public New<T> {
+    public:
+        New_for_overwrite()
+            requires std::default_initializable<T>
+            : New<T>(gc_default_init)
+        {
+        }
+    };
+
+    template <GcManaged T>
+    class New_for_overwrite<T[]> : public New<T[]> {
+    public:
+        explicit New_for_overwrite(std::size_t size)
+            requires std::default_initializable<T>
+            : New<T[]>(size, gc_default_init)
+        {
+        }
+    };
+
+    // ─────────────────────────────────────────────────────────────────────────────
+    // New_batch<T>  – many single objects at once
+    // ─────────────────────────────────────────────────────────────────────────────
+
+    /**
+     * @brief Allocate @p n independent objects of T in one request; a root to each.
+     *
+     * The allocation is charged to the collection trigger once, the cells are
+     * taken from the arena a batch at a time (consecutive ones, in a fresh
+     * chunk) and the objects are registered with the collector in one step.
+     * Each is then constructed from @p args, which are copied rather than
+     * forwarded, and is collected on its own.  Inside a Heap or a Region the
+     * objects are allocated one by one.
+     */
+    template <GcManaged T>
+    class New_batch : public std::vector<Ptr<T>> {
+    public:
+        template <typename... Args>
+            requires std::constructible_from<T, const Args&...>
+        explicit New_batch(std::size_t n, const Args&... args)
+            : std::vector<Ptr<T>>(n)
+        {
+            std::vector<gc_object*> objects(n);
+            gc_thread::allocate_batch(gc_object::overhead(false) + sizeof(T), gc_type_index<T>(), objects);
+
+            gc_object* parent = current;
+            std::size_t i = 0;
+            try {
+                for (; i != n; ++i) {
+                    // Takes over the root count allocate_batch() set.
+                    Ptr<T>& p = (*this)[i];
+                    p.object.store(objects[i], std::memory_order_relaxed);
+                    p.ptr = static_cast<T*>(objects[i]->start());
+                    current = objects[i];
+                    std::construct_at(p.ptr, args...);
+                }
+            }
+            catch (...) {
+                current = parent;
+                (*this)[i].object.store(nullptr, std::memory_order_relaxed);
+                (*this)[i].ptr = nullptr;
+                gc_thread::abandon_batch(std::span<gc_object* const>(objects).subspan(i));
+                throw;
+            }
+
+            current = parent;
+        }
     };
 
     // ─────────────────────────────────────────────────────────────────────────────
@@ -0,0 +1,588 @@
+#include "gc_arena.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <new>
+
+#if defined(_WIN32)
+#   define WIN32_LEAN_AND_MEAN
+#   include <windows.h>
+#elif defined(__unix__) || defined(__APPLE__)
+#   include <sys/mman.h>
+#endif
+
+namespace GC {
+
+    constinit thread_local gc_suspend_state gc_suspend;
+
+    namespace {
+
+        constexpr std::size_t round_up(std::size_t n, std::size_t a) noexcept
+        {
+            return (n + a - 1) & ~(a - 1);
+        }
+
+        // Chunk-aligned pages straight from the system, which hands them out
+        // zero-filled: a large span reads as zero until written.
+        void* map_span(std::size_t span)
+        {
+#if defined(_WIN32)
+            // Reserve a padded range to find an aligned address, then map just
+            // that; another thread may take it in between, hence the retries.
+            for (int attempt = 0; attempt != 8; ++attempt) {
+                void* probe = VirtualAlloc(nullptr, span + gc_chunk_size, MEM_RESERVE, PAGE_NOACCESS);
+                if (probe == nullptr)
+                    break;
+                void* aligned = reinterpret_cast<void*>(round_up(reinterpret_cast<std::uintptr_t>(probe), gc_chunk_size));
+                VirtualFree(probe, 0, MEM_RELEASE);
+                if (void* p = VirtualAlloc(aligned, span, MEM_RESERVE | MEM_COMMIT, PAGE_READWRITE))
+                    return p;
+            }
+            throw std::bad_alloc();
+#elif defined(__unix__) || defined(__APPLE__)
+            const std::size_t reserve = span + gc_chunk_size;
+            void* m = mmap(nullptr, reserve, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+            if (m == MAP_FAILED)
+                throw std::bad_alloc();
+            const std::uintptr_t base    = reinterpret_cast<std::uintptr_t>(m);
+            const std::uintptr_t aligned = round_up(base, gc_chunk_size);
+            if (aligned != base)
+                munmap(m, aligned - base);
+            if (const std::size_t tail = base + reserve - (aligned + span); tail != 0)
+                munmap(reinterpret_cast<void*>(aligned + span), tail);
+            return reinterpret_cast<void*>(aligned);
+#else
+            void* p = ::operator new(span, std::align_val_t{ gc_chunk_size });
+            std::memset(p, 0, span);
+            return p;
+#endif
+        }
+
+        void unmap_span(void* p, std::size_t span) noexcept
+        {
+#if defined(_WIN32)
+            (void)span;
+            VirtualFree(p, 0, MEM_RELEASE);
+#elif defined(__unix__) || defined(__APPLE__)
+            munmap(p, span);
+#else
+            ::operator delete(p, span, std::align_val_t{ gc_chunk_size });
+#endif
+        }
+
+    } // anonymous namespace
+
+    // ─────────────────────────────────────────────────────────────────────────────
+    // gc_arena – allocation
+    // ─────────────────────────────────────────────────────────────────────────────
+
+    void* gc_arena::allocate(std::size_t bytes)
+    {
+        if (bytes > gc_max_small_size)
+            return allocate_large(bytes);
+
+        const std::size_t cls = gc_size_class(bytes);
+
+        gc_deferring_lock lock{ mutex_ };
+        size_class_state& state = classes_[cls];
+
+        // Recycled cells first, then fresh cells from the newest chunk.
+        if (gc_free_cell* c = state.free_list) {
+            state.free_list = c->next;
+            return c;
+        }
+        if (state.bump == state.limit)
+            carve_chunk(cls);
+
+        void* p = state.bump;
+        state.bump += gc_class_size(cls);
+        return p;
+    }
+
+    void* gc_arena::bump_allocate(std::size_t bytes)
+    {
+        if (bytes > gc_max_small_size)
+            return allocate_large(bytes);
+
+        const std::size_t cls = gc_size_class(bytes);
+        size_class_state& state = classes_[cls];
+        if (state.bump == state.limit) {
+            gc_deferring_lock lock{ mutex_ };
+            carve_chunk(cls);
+        }
+
+        void* p = state.bump;
+        state.bump += gc_class_size(cls);
+        return p;
+    }
+
+    gc_free_cell* gc_arena::take(std::size_t cls, std::size_t n)
+    {
+        const std::size_t cell = gc_class_size(cls);
+        gc_free_cell* head = nullptr;
+        std::size_t   count = 0;
+
+        gc_deferring_lock lock{ mutex_ };
+        size_class_state& state = classes_[cls];
+
+        while (count < n) {
+            gc_free_cell* c;
+            if (state.free_list) {
+                c = state.free_list;
+                state.free_list = c->next;
+            }
+            else if (state.bump != state.limit) {
+                c = reinterpret_cast<gc_free_cell*>(state.bump);
+                state.bump += cell;
+            }
+            else if (count == 0) {
+                carve_chunk(cls);
+                continue;
+            }
+            else {
+                break;   // keep the batch rather than mapping another chunk
+            }
+            c->next = head;
+            head = c;
+            ++count;
+        }
+        return head;
+    }
+
+    // Map a fresh chunk for @p cls.  Cells are handed out by bumping through it,
+    // so pages are only touched once they are actually used.
+    void gc_arena::carve_chunk(std::size_t cls)
+    {
+        void* mem = map_span(gc_chunk_size);
+
+        const std::size_t cell = gc_class_size(cls);
+        const std::size_t count = (gc_chunk_size - gc_chunk::header_size) / cell;
+        auto* c = ::new (mem) gc_chunk{
+            static_cast<std::uint32_t>(cls),
+            static_cast<std::uint32_t>(cell),
+            static_cast<std::uint32_t>(count),
+            0,
+            0 };
+
+        try {
+            map_.assign(c, gc_chunk_size, c);
+        }
+        catch (...) {
+            unmap_span(mem, gc_chunk_size);
+            throw;
+        }
+        c->arena = this;
+        link_chunk_locked(c);
+        classes_[cls].bump  = c->cells();
+        classes_[cls].limit = c->cells() + count * cell;
+    }
+
+    void* gc_arena::allocate_large(std::size_t bytes)
+    {
+        const std::size_t span = round_up(gc_chunk::header_size + bytes, gc_chunk_size);
+        void* mem = map_span(span);
+
+        // Linked into the chunk list by enroll(): until then it has nothing to sweep.
+        auto* c = ::new (mem) gc_chunk{ gc_large_class, 0, 1, 0, bytes };
+        c->prev = c->next = c;
+        c->arena = this;
+        try {
+            gc_deferring_lock lock{ mutex_ };
+            map_.assign(c, span, c);
+        }
+        catch (...) {
+            unmap_span(mem, span);
+            throw;
+        }
+        return c->cells();
+    }
+
+    // New chunks go in front, so a walk that started earlier never sees them.
+    void gc_arena::link_chunk_locked(gc_chunk* c) noexcept
+    {
+        gc_chunk* head = chunks_.load(std::memory_order_relaxed);
+        c->prev = nullptr;
+        c->next = head;
+        if (head)
+            head->prev = c;
+        chunks_.store(c, std::memory_order_release);
+    }
+
+    // Idempotent; an unlinked chunk points back at itself.
+    void gc_arena::unlink_chunk_locked(gc_chunk* c) noexcept
+    {
+        if (c->prev == c)
+            return;
+        if (c->prev)
+            c->prev->next = c->next;
+        else
+            chunks_.store(c->next, std::memory_order_relaxed);
+        if (c->next)
+            c->next->prev = c->prev;
+        c->prev = c->next = c;
+    }
+
+    // ─────────────────────────────────────────────────────────────────────────────
+    // gc_arena – deallocation
+    // ─────────────────────────────────────────────────────────────────────────────
+
+    void gc_arena::enroll(void* block, bool finalize) noexcept
+    {
+        std::uint64_t bit;
+        const std::size_t w = gc_granule_of(block, bit);
+        gc_chunk* c = chunk_of(block);
+        c->live[w].fetch_or(bit, std::memory_order_relaxed);
+        if (finalize)
+            c->finalize[w].fetch_or(bit, std::memory_order_relaxed);
+        if (c->size_class == gc_large_class) {
+            gc_deferring_lock lock{ mutex_ };
+            link_chunk_locked(c);
+        }
+    }
+
+    void gc_arena::retire(void* block) noexcept
+    {
+        std::uint64_t bit;
+        const std::size_t w = gc_granule_of(block, bit);
+        gc_chunk* c = chunk_of(block);
+        c->live[w].fetch_and(~bit, std::memory_order_relaxed);
+        c->finalize[w].fetch_and(~bit, std::memory_order_relaxed);
+        if (c->size_class == gc_large_class) {
+            gc_deferring_lock lock{ mutex_ };
+            unlink_chunk_locked(c);
+        }
+    }
+
+    void gc_arena::deallocate(void* p) noexcept
+    {
+        gc_deferring_lock lock{ mutex_ };
+        deallocate_locked(p);
+    }
+
+    void gc_arena::give(gc_free_cell* list) noexcept
+    {
+        gc_deferring_lock lock{ mutex_ };
+        while (list) {
+            gc_free_cell* next = list->next;
+            deallocate_locked(list);
+            list = next;
+        }
+    }
+
+    void gc_arena::deallocate_locked(void* p) noexcept
+    {
+        gc_chunk* c = chunk_of(p);
+        if (c->size_class == gc_large_class) {
+            release_large_locked(c);
+            return;
+        }
+        size_class_state& state = classes_[c->size_class];
+        auto* cell = static_cast<gc_free_cell*>(p);
+        cell->next = state.free_list;
+        state.free_list = cell;
+    }
+
+    void gc_arena::release_large_locked(gc_chunk* c) noexcept
+    {
+        unlink_chunk_locked(c);
+        map_.assign(c, c->span(), nullptr);   // leaves already exist: cannot throw
+        unmap_span(c, c->span());
+    }
+
+    void gc_arena::finalize_all() noexcept
+    {
+        for (gc_chunk* c = chunks(); c != nullptr; c = c->next) {
+            for (std::size_t w = 0; w < gc_bitmap_words; ++w) {
+                std::uint64_t bits = c->finalize[w].load(std::memory_order_relaxed);
+                while (bits) {
+                    const std::size_t g = w * 64 + static_cast<std::size_t>(std::countr_zero(bits));
+                    bits &= bits - 1;
+                    finalize_(reinterpret_cast<char*>(c) + g * gc_mark_granule);
+                }
+            }
+        }
+    }
+
+    void gc_arena::release_all() noexcept
+    {
+        gc_deferring_lock lock{ mutex_ };
+        gc_chunk* c = chunks_.load(std::memory_order_relaxed);
+        while (c != nullptr) {
+            gc_chunk* next = c->next;
+            map_.assign(c, c->span(), nullptr);
+            unmap_span(c, c->span());
+            c = next;
+        }
+        chunks_.store(nullptr, std::memory_order_relaxed);
+        classes_ = {};
+        unswept_large_ = nullptr;
+        unswept_.store(0, std::memory_order_relaxed);
+    }
+
+    // ─────────────────────────────────────────────────────────────────────────────
+    // gc_arena – sweeping
+    // ─────────────────────────────────────────────────────────────────────────────
+
+    gc_arena::census_totals gc_arena::census() const noexcept
+    {
+        census_totals totals;
+        for (gc_chunk* c = chunks(); c != nullptr; c = c->next) {
+            std::size_t live = 0;
+            std::size_t marked = 0;
+            for (std::size_t w = 0; w < gc_bitmap_words; ++w) {
+                const std::uint64_t bits = c->live[w].load(std::memory_order_relaxed);
+                live += static_cast<std::size_t>(std::popcount(bits));
+                marked += static_cast<std::size_t>(std::popcount(bits & c->marks[w].load(std::memory_order_relaxed)));
+            }
+            const std::size_t size = c->size_class == gc_large_class ? c->block_size : c->cell_size;
+            totals.live_blocks += live;
+            totals.live_bytes += live * size;
+            totals.marked_blocks += marked;
+            totals.marked_bytes += marked * size;
+        }
+        return totals;
+    }
+
+    void gc_arena::clear_marks() noexcept
+    {
+        for (gc_chunk* c = chunks(); c != nullptr; c = c->next) {
+            for (std::atomic<std::uint64_t>& w : c->marks)
+                w.store(0, std::memory_order_relaxed);
+        }
+    }
+
+    void gc_arena::schedule_sweep() noexcept
+    {
+        gc_deferring_lock lock{ mutex_ };
+        std::size_t n = 0;
+        for (gc_chunk* c = chunks_.load(std::memory_order_relaxed); c != nullptr; c = c->next) {
+            gc_chunk*& queue = c->size_class == gc_large_class
+                ? unswept_large_
+                : classes_[c->size_class].unswept;
+            c->sweep_next = queue;
+            queue = c;
+            ++n;
+        }
+        unswept_.store(n, std::memory_order_release);
+    }
+
+    bool gc_arena::sweep(std::size_t cls)
+    {
+        std::array<std::uint64_t, gc_bitmap_words> dead;
+        std::array<std::uint64_t, gc_bitmap_words> doomed;   ///< dead, with a finalizer to run
+        bool      any_dead = false;
+        gc_chunk* c;
+        {
+            gc_deferring_lock lock{ mutex_ };
+            gc_chunk*& queue = cls == gc_size_class_count ? unswept_large_ : classes_[cls].unswept;
+            c = queue;
+            if (c == nullptr)
+                return false;
+            queue = c->sweep_next;
+
+            // The bitmaps settle at once: whatever the finalizers below take,
+            // the chunk counts as swept and its survivors as white.
+            for (std::size_t w = 0; w < gc_bitmap_words; ++w) {
+                const std::uint64_t marks = c->marks[w].load(std::memory_order_relaxed);
+                const std::uint64_t live  = c->live[w].load(std::memory_order_relaxed);
+                const std::uint64_t fin   = c->finalize[w].load(std::memory_order_relaxed);
+                dead[w]   = live & ~marks;
+                doomed[w] = dead[w] & fin;
+                any_dead  = any_dead || dead[w] != 0;
+                c->live[w].store(live & marks, std::memory_order_relaxed);
+                c->finalize[w].store(fin & marks, std::memory_order_relaxed);
+                c->marks[w].store(0, std::memory_order_relaxed);
+            }
+            if (c->size_class == gc_large_class && any_dead)
+                unlink_chunk_locked(c);   // walkers must not reach it once the count drops
+            unswept_.fetch_sub(1, std::memory_order_release);
+        }
+        if (!any_dead)
+            return true;
+
+        auto for_each = [&](const std::array<std::uint64_t, gc_bitmap_words>& set, auto&& f) {
+            for (std::size_t w = 0; w < gc_bitmap_words; ++w) {
+                for (std::uint64_t bits = set[w]; bits != 0; bits &= bits - 1) {
+                    const std::size_t granule = w * 64 + static_cast<std::size_t>(std::countr_zero(bits));
+                    f(reinterpret_cast<char*>(c) + granule * gc_mark_granule);
+                }
+            }
+        };
+
+        // Finalizers may allocate, which may sweep in turn: no lock held.
+        for_each(doomed, [&](void* block) {
+            if (!finalize_(block)) {
+                std::uint64_t bit;
+                dead[gc_granule_of(block, bit)] &= ~bit;   // finalized and freed by its owner later
+            }
+        });
+
+        gc_deferring_lock lock{ mutex_ };
+        for_each(dead, [&](void* block) { deallocate_locked(block); });
+        return true;
+    }
+
+    void gc_arena::finish_sweep()
+    {
+        while (sweep_pending()) {
+            bool swept = false;
+            for (std::size_t cls = 0; cls <= gc_size_class_count; ++cls)
+                swept = sweep(cls) || swept;
+            if (!swept)
+                break;   // the rest is being swept by other threads right now
+        }
+    }
+
+    // ─────────────────────────────────────────────────────────────────────────────
+    // gc_arena – evacuation
+    // ─────────────────────────────────────────────────────────────────────────────
+
+    std::vector<gc_chunk*> gc_arena::begin_evacuation(double occupancy)
+    {
+        std::vector<gc_chunk*> picked;
+        gc_deferring_lock lock{ mutex_ };
+
+        // Free cells per chunk; those past a bump cursor were never handed out.
+        for (gc_chunk* c = chunks_.load(std::memory_order_relaxed); c != nullptr; c = c->next)
+            c->free_count = 0;
+        for (std::size_t cls = 0; cls < gc_size_class_count; ++cls) {
+            size_class_state& state = classes_[cls];
+            for (gc_free_cell* f = state.free_list; f != nullptr; f = f->next)
+                ++chunk_of(f)->free_count;
+            if (state.bump != state.limit)
+                chunk_of(state.bump)->free_count += static_cast<std::uint32_t>((state.limit - state.bump) / gc_class_size(cls));
+        }
+
+        for (gc_chunk* c = chunks_.load(std::memory_order_relaxed); c != nullptr; c = c->next) {
+            if (c->size_class == gc_large_class)
+                continue;
+            std::size_t live = 0;
+            for (const std::atomic<std::uint64_t>& w : c->live)
+                live += static_cast<std::size_t>(std::popcount(w.load(std::memory_order_relaxed)));
+            if (live + c->free_count == c->cell_count && static_cast<double>(live) <= occupancy * c->cell_count)
+                picked.push_back(c);
+        }
+
+        // Withdraw the free cells of the picked chunks.
+        for (gc_chunk* c : picked)
+            c->evacuating = true;
+        for (size_class_state& state : classes_) {
+            gc_free_cell** link = &state.free_list;
+            while (*link != nullptr) {
+                if (chunk_of(*link)->evacuating)
+                    *link = (*link)->next;
+                else
+                    link = &(*link)->next;
+            }
+            if (state.bump != state.limit && chunk_of(state.bump)->evacuating)
+                state.bump = state.limit = nullptr;
+        }
+        return picked;
+    }
+
+    void gc_arena::end_evacuation(std::span<gc_chunk* const> chunks) noexcept
+    {
+        gc_deferring_lock lock{ mutex_ };
+        for (gc_chunk* c : chunks) {
+            c->evacuating = false;
+
+            bool any_live = false;
+            for (const std::atomic<std::uint64_t>& w : c->live)
+                any_live = any_live || w.load(std::memory_order_relaxed) != 0;
+            if (!any_live) {
+                unlink_chunk_locked(c);
+                map_.assign(c, c->span(), nullptr);   // leaves already exist: cannot throw
+                unmap_span(c, c->span());
+                continue;
+            }
+
+            // Every cell but the pinned blocks is free: nothing else was in use.
+            size_class_state& state = classes_[c->size_class];
+            char* cell = c->cells();
+            for (std::uint32_t i = 0; i != c->cell_count; ++i, cell += c->cell_size) {
+                if (!gc_live(cell)) {
+                    auto* f = reinterpret_cast<gc_free_cell*>(cell);
+                    f->next = state.free_list;
+                    state.free_list = f;
+                }
+            }
+        }
+    }
+
+    // ─────────────────────────────────────────────────────────────────────────────
+    // gc_arena – address lookup
+    // ─────────────────────────────────────────────────────────────────────────────
+
+    void* gc_arena::block_of(const void* p) const noexcept
+    {
+        gc_chunk* c = map_.find(p);
+        if (c == nullptr || c->arena != this)
+            return nullptr;
+
+        const char* a = static_cast<const char*>(p);
+        char* cells = c->cells();
+        if (a < cells)
+            return nullptr;
+        if (c->size_class == gc_large_class)
+            return cells;
+
+        const std::size_t idx = static_cast<std::size_t>(a - cells) / c->cell_size;
+        return idx < c->cell_count ? cells + idx * c->cell_size : nullptr;
+    }
+
+    // ─────────────────────────────────────────────────────────────────────────────
+    // gc_page_map
+    // ─────────────────────────────────────────────────────────────────────────────
+
+    constinit gc_page_map gc_arena::map_;
+
+    void gc_page_map::assign(const void* begin, std::size_t bytes, gc_chunk* c)
+    {
+        const std::uintptr_t first = reinterpret_cast<std::uintptr_t>(begin) >> chunk_bits;
+        const std::uintptr_t last  = (reinterpret_cast<std::uintptr_t>(begin) + bytes - 1) >> chunk_bits;
+
+        if (last >> (root_bits + leaf_bits))
+            throw std::bad_alloc();   // outside the mapped address space
+
+        for (std::uintptr_t n = first; n <= last; ++n) {
+            std::atomic<leaf*>& slot = root_[n >> leaf_bits];
+            leaf* l = slot.load(std::memory_order_relaxed);
+            if (l == nullptr) {
+                auto fresh = std::make_unique<leaf>();
+                if (slot.compare_exchange_strong(l, fresh.get(), std::memory_order_acq_rel, std::memory_order_acquire))
+                    l = fresh.release();   // else another arena won: l is its leaf
+            }
+            (*l)[n & (leaf_entries - 1)].store(c, std::memory_order_release);
+        }
+    }
+
+    // ─────────────────────────────────────────────────────────────────────────────
+    // gc_cell_cache
+    // ─────────────────────────────────────────────────────────────────────────────
+
+    gc_free_cell* gc_cell_cache::refill(std::size_t cls)
+    {
+        // Roughly 16 KiB per batch: enough to amortise the arena lock without
+        // stranding much memory in threads that stop allocating.
+        const std::size_t n = std::clamp<std::size_t>(16 * 1024 / gc_class_size(cls), 4, 64);
+
+        // Dead cells of a queued chunk before fresh memory.  The finalizers
+        // may allocate through this cache and refill the bin themselves.
+        if (arena.sweep_pending() && arena.sweep(cls) && bins_[cls])
+            return bins_[cls];
+        return bins_[cls] = arena.take(cls, n);
+    }
+
+    void gc_cell_cache::flush() noexcept
+    {
+        for (gc_free_cell*& bin : bins_) {
+            if (bin) {
+                arena.give(bin);
+                bin = nullptr;
+            }
+        }
+    }
+
+} // namespace GC
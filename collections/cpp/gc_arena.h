@@ -0,0 +1,546 @@
+#pragma once
+
+/**
+ * @file gc_arena.h
+ * @brief Segregated size-class arena backing GC::New.
+ *
+ * Small blocks (gc_object header + payload up to gc_max_small_size bytes) are
+ * carved out of chunks that hold cells of a single size class.  Freed cells go
+ * onto a per-class free list and are handed out again without calling into the
+ * system allocator.  Larger blocks get a dedicated chunk-aligned span.  Chunks
+ * are mapped from the system directly, so a large block starts out zeroed.
+ *
+ * Every chunk is aligned to gc_chunk_size, so the chunk header of any block is
+ * found by masking its address.  The header also holds the chunk's bitmaps,
+ * which keep the collector from writing to the cells themselves.
+ *
+ * Sweeping is lazy: after a full mark every chunk is queued, and a queued
+ * chunk is swept the next time a thread needs cells of its size class, or
+ * by whoever drains the queue first (see gc_arena::sweep()).
+ */
+
+#include <array>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <span>
+#include <vector>
+
+namespace GC {
+
+    // ─────────────────────────────────────────────────────────────────────────────
+    // Size classes
+    // ─────────────────────────────────────────────────────────────────────────────
+
+    inline constexpr std::size_t   gc_chunk_size       = std::size_t{ 1 } << 18;   ///< 256 KiB, also the chunk alignment
+    inline constexpr std::size_t   gc_max_small_size   = 32 * 1024;                ///< largest block served from a size class
+    inline constexpr std::size_t   gc_size_class_count = 40;
+    inline constexpr std::uint32_t gc_large_class      = 0xFFFF'FFFFu;             ///< size_class tag of a dedicated span
+    inline constexpr std::size_t   gc_mark_granule     = 16;                       ///< bytes covered by one mark bit
+    inline constexpr std::size_t   gc_bitmap_words     = gc_chunk_size / gc_mark_granule / 64;
+
+    /**
+     * @brief Size-class index for a block of @p bytes (1 <= bytes <= gc_max_small_size).
+     *
+     * Classes are 16 bytes apart up to 128 bytes, then four classes per power of
+     * two, which bounds internal fragmentation at 20%.
+     */
+    [[nodiscard]] constexpr std::size_t gc_size_class(std::size_t bytes) noexcept
+    {
+        if (bytes <= 128)
+            return bytes == 0 ? 0 : (bytes + 15) / 16 - 1;
+
+        const std::size_t n    = static_cast<std::size_t>(std::bit_width(bytes - 1));
+        const std::size_t base = std::size_t{ 1 } << (n - 1);
+        const std::size_t step = std::size_t{ 1 } << (n - 3);
+        return 8 + (n - 8) * 4 + (bytes - base + step - 1) / step - 1;
+    }
+
+    /// Cell size of size-class @p cls.
+    [[nodiscard]] constexpr std::size_t gc_class_size(std::size_t cls) noexcept
+    {
+        if (cls < 8)
+            return (cls + 1) * 16;
+
+        const std::size_t n = (cls - 8) / 4 + 8;
+        return (std::size_t{ 1 } << (n - 1)) + ((cls - 8) % 4 + 1) * (std::size_t{ 1 } << (n - 3));
+    }
+
+    static_assert(gc_size_class(gc_max_small_size) == gc_size_class_count - 1);
+    static_assert(gc_class_size(gc_size_class_count - 1) == gc_max_small_size);
+
+    /// Whether a block of @p bytes gets a span of its own, freshly mapped and so zeroed.
+    [[nodiscard]] constexpr bool gc_large_block(std::size_t bytes) noexcept
+    {
+        return bytes > gc_max_small_size;
+    }
+
+    // ─────────────────────────────────────────────────────────────────────────────
+    // Deferred suspension
+    // ─────────────────────────────────────────────────────────────────────────────
+
+    /**
+     * @brief Per-thread count of the sections a stop-the-world waits out.
+     *
+     * With stack scanning on (see GC::gc_enable_stack_scanning()) the collector
+     * stops every other thread with a signal, wherever it happens to be.  A
+     * thread stopped while holding a lock the collector needs would never let
+     * go of it, so such locks are taken through gc_deferring_lock: a suspend
+     * signal that lands inside one only sets `pending`, and the thread stands
+     * still by itself once its outermost section ends.
+     */
+    struct gc_suspend_state {
+        std::atomic<unsigned> depth{ 0 };
+        std::atomic<bool>     pending{ false };
+    };
+
+    extern constinit thread_local gc_suspend_state gc_suspend;
+
+    /// Stand still for the stop held back by a gc_deferring_lock; defined with the collector.
+    void gc_suspend_deferred() noexcept;
+
+    /**
+     * @brief Holds @p m for its lifetime, with suspension deferred meanwhile.
+     *
+     * The section counts only once the lock is held: a thread still waiting
+     * for it can be stopped outright.
+     */
+    template <typename Mutex>
+    class gc_deferring_lock {
+    public:
+        explicit gc_deferring_lock(Mutex& m) : mutex_(m)
+        {
+            mutex_.lock();
+            gc_suspend.depth.fetch_add(1, std::memory_order_relaxed);
+            std::atomic_signal_fence(std::memory_order_seq_cst);
+        }
+
+        ~gc_deferring_lock()
+        {
+            mutex_.unlock();
+            std::atomic_signal_fence(std::memory_order_seq_cst);   // released before the section ends
+            if (gc_suspend.depth.fetch_sub(1, std::memory_order_relaxed) == 1 &&
+                gc_suspend.pending.load(std::memory_order_relaxed))
+                gc_suspend_deferred();
+        }
+
+        gc_deferring_lock(const gc_deferring_lock&) = delete;
+        gc_deferring_lock& operator=(const gc_deferring_lock&) = delete;
+
+    private:
+        Mutex& mutex_;
+    };
+
+    // ─────────────────────────────────────────────────────────────────────────────
+    // gc_chunk
+    // ─────────────────────────────────────────────────────────────────────────────
+
+    /**
+     * @brief Header at the start of every chunk.
+     *
+     * Memory layout: [gc_chunk][bitmaps][cell 0][cell 1]...  for a size-class chunk,
+     *                [gc_chunk][bitmaps][block]             for a large span.
+     *
+     * Each bitmap has one bit per gc_mark_granule bytes of the first chunk; a
+     * block is described by the bit of its first granule.  `live` is set for
+     * blocks registered with the collector: only those are ever swept, so a
+     * cell still sitting in a young list survives a sweep whatever its mark.
+     * `finalize` is set for the live blocks that need their destructor run;
+     * the others are freed without being read.
+     */
+    class gc_arena;
+
+    struct gc_chunk {
+        std::uint32_t size_class;              ///< index into the size-class table, or gc_large_class
+        std::uint32_t cell_size;               ///< bytes per cell (0 for a large span)
+        std::uint32_t cell_count;              ///< cells in the chunk (1 for a large span)
+        std::uint32_t free_count{ 0 };         ///< free cells, as counted by begin_evacuation()
+        std::size_t   block_size;              ///< bytes asked for the block of a large span (0 for a size class)
+        gc_chunk*     prev{ nullptr };         ///< the arena's chunk list
+        gc_chunk*     next{ nullptr };
+        gc_chunk*     sweep_next{ nullptr };   ///< the arena's sweep queue
+        gc_arena*     arena{ nullptr };        ///< the arena that mapped it
+        bool          evacuating{ false };     ///< between begin_evacuation() and end_evacuation()
+
+        alignas(64) std::array<std::atomic<std::uint64_t>, gc_bitmap_words> marks{};
+        std::array<std::atomic<std::uint64_t>, gc_bitmap_words>             live{};
+        std::array<std::atomic<std::uint64_t>, gc_bitmap_words>             finalize{};
+
+        static constexpr std::size_t header_size = 64 + 3 * gc_bitmap_words * 8;
+
+        [[nodiscard]] char* cells() noexcept { return reinterpret_cast<char*>(this) + header_size; }
+
+        /// Bytes reserved for this chunk, header included: a whole number of chunks.
+        [[nodiscard]] std::size_t span() const noexcept
+        {
+            return size_class == gc_large_class
+                ? (header_size + block_size + gc_chunk_size - 1) & ~(gc_chunk_size - 1)
+                : gc_chunk_size;
+        }
+    };
+
+    static_assert(sizeof(gc_chunk) <= gc_chunk::header_size);
+    static_assert(gc_chunk::header_size % gc_mark_granule == 0);
+
+    // ─────────────────────────────────────────────────────────────────────────────
+    // gc_page_map
+    // ─────────────────────────────────────────────────────────────────────────────
+
+    /**
+     * @brief Two-level radix map from chunk-sized address ranges to their gc_chunk.
+     *
+     * Covers the 48-bit user address space; leaves are allocated on first use.
+     * Lookups are lock-free, updates happen under the lock of the arena that
+     * owns the range.  One map serves every arena; leaves are installed with a
+     * CAS.  Needed for interior addresses of large spans, which cannot be
+     * resolved by masking.
+     */
+    class gc_page_map {
+    public:
+        [[nodiscard]] gc_chunk* find(const void* p) const noexcept
+        {
+            const std::uintptr_t n = reinterpret_cast<std::uintptr_t>(p) >> chunk_bits;
+            if (n >> (root_bits + leaf_bits))
+                return nullptr;
+            const leaf* l = root_[n >> leaf_bits].load(std::memory_order_acquire);
+            return l ? (*l)[n & (leaf_entries - 1)].load(std::memory_order_acquire) : nullptr;
+        }
+
+        /// Map [begin, begin + bytes) to @p c (nullptr to unmap).  Caller holds the owning arena's lock.
+        void assign(const void* begin, std::size_t bytes, gc_chunk* c);
+
+    private:
+        static constexpr unsigned    address_bits = 48;
+        static constexpr unsigned    chunk_bits   = std::countr_zero(gc_chunk_size);
+        static constexpr unsigned    leaf_bits    = (address_bits - chunk_bits) / 2;
+        static constexpr unsigned    root_bits    = address_bits - chunk_bits - leaf_bits;
+        static constexpr std::size_t leaf_entries = std::size_t{ 1 } << leaf_bits;
+
+        using leaf = std::array<std::atomic<gc_chunk*>, leaf_entries>;
+
+        std::array<std::atomic<leaf*>, std::size_t{ 1 } << root_bits> root_{};
+    };
+
+    // ─────────────────────────────────────────────────────────────────────────────
+    // gc_arena
+    // ─────────────────────────────────────────────────────────────────────────────
+
+    /// A free cell; the link lives in the cell's first word.
+    struct gc_free_cell {
+        gc_free_cell* next;
+    };
+
+    class gc_arena {
+    public:
+        /**
+         * Runs the destructor of a dead block found by sweep(); must not free
+         * it.  Returns false to keep the block allocated instead, for its
+         * owner to finalize and deallocate() later.
+         */
+        using finalizer = bool (*)(void* block) noexcept;
+
+        /// @p context is left for the owner to find through chunk_of(block)->arena.
+        constexpr explicit gc_arena(finalizer f, void* context = nullptr) noexcept
+            : finalize_(f), context_(context) {}
+        gc_arena(const gc_arena&) = delete;
+        gc_arena& operator=(const gc_arena&) = delete;
+
+        [[nodiscard]] void* context() const noexcept { return context_; }
+
+        /**
+         * @brief Unmap every chunk and start over empty.
+         *
+         * Nothing in the arena is finalized: sweep it first.  No block may be
+         * in use, cached or referenced any more.
+         */
+        void release_all() noexcept;
+
+        /**
+         * @brief Run the finalizer of every block whose finalize bit is set.
+         *
+         * Costs a bitmap scan per chunk, plus the finalizers, which must not
+         * keep any block.  Nothing is freed: release_all() next.  Nobody else
+         * may use the arena meanwhile.
+         */
+        void finalize_all() noexcept;
+
+        /// Allocate a block of at least @p bytes, aligned to 16 bytes.
+        [[nodiscard]] void* allocate(std::size_t bytes);
+
+        /**
+         * @brief allocate() for an arena that only the calling thread allocates from.
+         *
+         * Small blocks are bumped off the newest chunk of their class without
+         * the lock, and free lists are ignored; the lock is taken per chunk.
+         */
+        [[nodiscard]] void* bump_allocate(std::size_t bytes);
+
+        /// Return a block obtained from allocate().  Small cells go back to their free list.
+        void deallocate(void* p) noexcept;
+
+        /// Detach up to @p n free cells of class @p cls as a linked list (never empty).
+        [[nodiscard]] gc_free_cell* take(std::size_t cls, std::size_t n);
+
+        /// Return a linked list of free cells, possibly of mixed classes.
+        void give(gc_free_cell* list) noexcept;
+
+        /// Return a batch of blocks under a single lock acquisition.
+        template <typename T>
+        void deallocate(std::span<T* const> blocks) noexcept
+        {
+            gc_deferring_lock lock{ mutex_ };
+            for (T* p : blocks)
+                deallocate_locked(p);
+        }
+
+        /// Start of the block containing @p p, or nullptr if @p p is not arena memory.
+        [[nodiscard]] void* block_of(const void* p) const noexcept;
+
+        /// Arena whose chunk holds @p p, or nullptr if it is none's.
+        [[nodiscard]] static gc_arena* owner_of(const void* p) noexcept
+        {
+            const gc_chunk* c = map_.find(p);
+            return c ? c->arena : nullptr;
+        }
+
+        /// Chunk header of a block returned by allocate().
+        [[nodiscard]] static gc_chunk* chunk_of(const void* p) noexcept
+        {
+            return reinterpret_cast<gc_chunk*>(
+                reinterpret_cast<std::uintptr_t>(p) & ~(gc_chunk_size - 1));
+        }
+
+        /// Bytes taken up by a block returned by allocate(): its cell, or as much as was asked for a large one.
+        [[nodiscard]] static std::size_t block_size(const void* p) noexcept
+        {
+            const gc_chunk* c = chunk_of(p);
+            return c->size_class == gc_large_class ? c->block_size : c->cell_size;
+        }
+
+        /**
+         * @brief Newest chunk; follow gc_chunk::next for the rest.
+         *
+         * May be walked without the lock while no sweep is pending: chunks
+         * mapped meanwhile are put in front and simply not visited, and chunks
+         * are only unmapped by sweeping.
+         */
+        [[nodiscard]] gc_chunk* chunks() const noexcept { return chunks_.load(std::memory_order_acquire); }
+
+        /**
+         * @brief Next live block at or after granule @p g of chunk @p c.
+         *
+         * Moves on along the chunk list as needed and leaves @p c / @p g one
+         * past the block returned, so that repeated calls enumerate every
+         * live block.  Returns nullptr once the list is exhausted.
+         */
+        [[nodiscard]] static void* next_live(gc_chunk*& c, std::size_t& g) noexcept
+        {
+            for (; c != nullptr; c = c->next, g = 0) {
+                for (std::size_t w = g / 64; w < gc_bitmap_words; ++w) {
+                    std::uint64_t bits = c->live[w].load(std::memory_order_relaxed);
+                    if (w == g / 64)
+                        bits &= ~std::uint64_t{ 0 } << (g % 64);
+                    if (bits != 0) {
+                        const std::size_t granule = w * 64 + static_cast<std::size_t>(std::countr_zero(bits));
+                        g = granule + 1;
+                        return reinterpret_cast<char*>(c) + granule * gc_mark_granule;
+                    }
+                }
+            }
+            return nullptr;
+        }
+
+        /// Live blocks across every chunk, and those of them with a set mark bit.
+        struct census_totals {
+            std::size_t live_blocks{ 0 };
+            std::size_t live_bytes{ 0 };     ///< block_size() summed
+            std::size_t marked_blocks{ 0 };
+            std::size_t marked_bytes{ 0 };
+        };
+
+        [[nodiscard]] census_totals census() const noexcept;
+
+        /// Clear every mark bit.  Caller holds gc_mutex and no sweep is pending.
+        void clear_marks() noexcept;
+
+        /// Queue every chunk for sweep().  Caller holds gc_mutex and no sweep is pending.
+        void schedule_sweep() noexcept;
+
+        /**
+         * @brief Pick the sparse small chunks to move blocks out of.
+         *
+         * A chunk qualifies when its live blocks fill at most @p occupancy of
+         * it and every other cell is on a free list: none is cached, queued or
+         * otherwise in use.  Its free cells are withdrawn, so that allocate()
+         * places blocks elsewhere until end_evacuation().  Caller holds
+         * gc_mutex and no sweep is pending.
+         */
+        [[nodiscard]] std::vector<gc_chunk*> begin_evacuation(double occupancy);
+
+        /// Unmap the chunks left without live blocks; the others' dead cells become free again.
+        void end_evacuation(std::span<gc_chunk* const> chunks) noexcept;
+
+        /**
+         * @brief Make a block visible to chunks() walks and to sweeping.
+         *
+         * Sets its live bit, and its finalize bit if @p finalize; a large span
+         * also joins the chunk list here, so spans that were never enrolled
+         * can be freed without unlinking.  Caller holds gc_mutex and no sweep
+         * is pending.
+         */
+        void enroll(void* block, bool finalize) noexcept;
+
+        /**
+         * @brief Take a dead block out of the collector's view before it is freed.
+         *
+         * Clears its bits and drops a large span from the chunk list, so a
+         * walker that starts while the block is being finalized skips it.
+         * Caller holds gc_mutex and no sweep is pending.
+         */
+        void retire(void* block) noexcept;
+
+        /// Whether any chunk is still queued for sweep().
+        [[nodiscard]] bool sweep_pending() const noexcept
+        {
+            return unswept_.load(std::memory_order_acquire) != 0;
+        }
+
+        /**
+         * @brief Sweep one queued chunk of size class @p cls (gc_size_class_count: large spans).
+         *
+         * Live blocks without a mark bit are finalized outside the arena lock
+         * where their finalize bit asks for it, and then freed unless the
+         * finalizer kept them; survivors lose
+         * their mark.  Run it only where the
+         * finalizer may allocate and take gc_mutex.  Returns false if no chunk
+         * of that class was queued.
+         */
+        bool sweep(std::size_t cls);
+
+        /// sweep() until nothing is queued.
+        void finish_sweep();
+
+    private:
+        struct size_class_state {
+            gc_free_cell* free_list{ nullptr };
+            char*         bump{ nullptr };     ///< next never-used cell of the newest chunk
+            char*         limit{ nullptr };
+            gc_chunk*     unswept{ nullptr };  ///< sweep queue of this class
+        };
+
+        std::mutex                                             mutex_;
+        std::array<size_class_state, gc_size_class_count>      classes_{};
+        gc_chunk*                                              unswept_large_{ nullptr };
+        std::atomic<std::size_t>                               unswept_{ 0 };   ///< chunks queued in total
+        std::atomic<gc_chunk*>                                 chunks_{ nullptr };
+        finalizer                                              finalize_;
+        void*                                                  context_;
+        static gc_page_map                                     map_;   ///< shared by every arena
+
+        void  deallocate_locked(void* p) noexcept;
+        void  link_chunk_locked(gc_chunk* c) noexcept;
+        void  unlink_chunk_locked(gc_chunk* c) noexcept;
+        void  carve_chunk(std::size_t cls);
+        void* allocate_large(std::size_t bytes);
+        void  release_large_locked(gc_chunk* c) noexcept;
+    };
+
+    extern gc_arena arena;   ///< backing store for every gc_object
+
+    // ─────────────────────────────────────────────────────────────────────────────
+    // Bitmaps
+    // ─────────────────────────────────────────────────────────────────────────────
+
+    /// Word index and bit of the block starting at @p p within its chunk's bitmaps.
+    [[nodiscard]] inline std::size_t gc_granule_of(const void* p, std::uint64_t& bit) noexcept
+    {
+        const std::size_t granule =
+            (reinterpret_cast<std::uintptr_t>(p) & (gc_chunk_size - 1)) / gc_mark_granule;
+        bit = std::uint64_t{ 1 } << (granule % 64);
+        return granule / 64;
+    }
+
+    /// Bitmap word and bit holding the mark of the block starting at @p p.
+    [[nodiscard]] inline std::atomic<std::uint64_t>& gc_mark_word(const void* p, std::uint64_t& bit) noexcept
+    {
+        return gc_arena::chunk_of(p)->marks[gc_granule_of(p, bit)];
+    }
+
+    [[nodiscard]] inline bool gc_live(const void* p) noexcept
+    {
+        std::uint64_t bit;
+        const std::size_t w = gc_granule_of(p, bit);
+        return (gc_arena::chunk_of(p)->live[w].load(std::memory_order_relaxed) & bit) != 0;
+    }
+
+    [[nodiscard]] inline bool gc_marked(const void* p) noexcept
+    {
+        std::uint64_t bit;
+        return (gc_mark_word(p, bit).load(std::memory_order_relaxed) & bit) != 0;
+    }
+
+    /// Set or clear a mark bit.  The caller keeps other markers out (gc_mutex).
+    inline void gc_set_marked(const void* p, bool marked) noexcept
+    {
+        std::uint64_t bit;
+        std::atomic<std::uint64_t>& w = gc_mark_word(p, bit);
+        const std::uint64_t v = w.load(std::memory_order_relaxed);
+        w.store(marked ? v | bit : v & ~bit, std::memory_order_relaxed);
+    }
+
+    /// Atomic test-and-set, safe against concurrent markers; true if it was already set.
+    [[nodiscard]] inline bool gc_test_and_mark(const void* p) noexcept
+    {
+        std::uint64_t bit;
+        return (gc_mark_word(p, bit).fetch_or(bit, std::memory_order_relaxed) & bit) != 0;
+    }
+
+    // ─────────────────────────────────────────────────────────────────────────────
+    // gc_cell_cache
+    // ─────────────────────────────────────────────────────────────────────────────
+
+    /**
+     * @brief Thread-private stash of free cells (thread-local allocation buffer).
+     *
+     * Each size class keeps a short list of cells detached from the arena, so
+     * the common allocation is a pointer pop with no lock.  An empty bin is
+     * refilled with one batch under the arena lock, after sweeping a chunk of
+     * that class if one is queued; large blocks always go to the arena
+     * directly, likewise after sweeping a queued large span.  Sweeping runs
+     * destructors, so allocate() must not be called with gc_mutex held.
+     */
+    class gc_cell_cache {
+    public:
+        gc_cell_cache() = default;
+        gc_cell_cache(const gc_cell_cache&) = delete;
+        gc_cell_cache& operator=(const gc_cell_cache&) = delete;
+        ~gc_cell_cache() { flush(); }
+
+        [[nodiscard]] void* allocate(std::size_t bytes)
+        {
+            if (bytes > gc_max_small_size) {
+                if (arena.sweep_pending())
+                    arena.sweep(gc_size_class_count);
+                return arena.allocate(bytes);
+            }
+
+            const std::size_t cls = gc_size_class(bytes);
+            gc_free_cell* c = bins_[cls];
+            if (c == nullptr)
+                c = refill(cls);
+            bins_[cls] = c->next;
+            return c;
+        }
+
+        /// Hand every cached cell back to the arena.
+        void flush() noexcept;
+
+    private:
+        std::array<gc_free_cell*, gc_size_class_count> bins_{};
+
+        gc_free_cell* refill(std::size_t cls);
+    };
+
+} // namespace GC
@@ -15,10 +15,25 @@ extern "C" {
         void* raw;
     } PtrBase;
 
-    // Base allocators
+    // Base allocators: blocks on the collected heap, rooted until gc_free()
     PtrBase new_malloc(size_t size);
     PtrBase new_calloc(size_t count, size_t size);
 
+    // Drop a block from new_malloc / new_calloc; a later collection reclaims
+    // it, once no other block points into it. NULL is ignored.
+    void gc_free(void* ptr);
+
+    // Run a full collection now
+    void gc_collect(void);
+
+    // Find roots on the thread stacks from now on: blocks stay alive while a
+    // pointer to them is on a stack, without gc_free(). POSIX only; returns 0
+    // where unsupported. See GC::gc_enable_stack_scanning().
+    int gc_enable_stack_scanning(void);
+
+    // Make the calling thread's stack visible before its first allocation
+    void gc_register_thread(void);
+
 // Allocate one object of type T
 #define New(T) \
     ((T*)new_malloc(sizeof(T)).raw)
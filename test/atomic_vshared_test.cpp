@@ -0,0 +1,91 @@
+// AtomicVSharedPtr: three readers load() while a writer runs 100k store()
+// and exchange() calls and another thread compare-exchanges; no load sees
+// a destroyed object, and every object created is destroyed once.
+
+#include "collections/meta.h"
+#include "check.h"
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+namespace {
+
+    std::atomic<long> created{ 0 };
+    std::atomic<long> destroyed{ 0 };
+
+    struct snap {
+        long id;
+        long check;
+
+        explicit snap(long i) : id(i), check(i * 7) { ++created; }
+        ~snap() { check = -1; ++destroyed; }
+    };
+
+} // anonymous namespace
+
+int main()
+{
+    static_assert(ptr::AtomicVSharedPtr<snap>::is_always_lock_free);
+    constexpr long updates = 100000;
+    constexpr int  readers = 3;
+
+    {
+        ptr::AtomicVSharedPtr<snap> slot(ptr::VMakeShared<snap>(0));
+        std::atomic<bool> stop{ false };
+        std::atomic<long> bad{ 0 };
+        std::atomic<long> loads{ 0 };
+
+        std::vector<std::thread> threads;
+        for (int r = 0; r < readers; ++r) {
+            threads.emplace_back([&] {
+                long n = 0;
+                while (!stop.load(std::memory_order_relaxed)) {
+                    auto s = slot.load();
+                    if (!s || s.get()->check != s.get()->id * 7)
+                        ++bad;
+                    ++n;
+                }
+                loads += n;
+            });
+        }
+
+        std::thread casser([&] {
+            for (long i = 0; i < updates / 4; ++i) {
+                auto current = slot.load();
+                while (!slot.compare_exchange_strong(current, ptr::VMakeShared<snap>(current.get()->id + 1'000'000'000))) {
+                }
+            }
+        });
+
+        for (long i = 1; i <= updates; ++i) {
+            if (i % 3 == 0) {
+                auto old = slot.exchange(ptr::VMakeShared<snap>(i));
+                if (!old || old.get()->check != old.get()->id * 7)
+                    ++bad;
+            }
+            else {
+                slot.store(ptr::VMakeShared<snap>(i));
+            }
+        }
+        casser.join();
+        stop.store(true);
+        for (std::thread& t : threads)
+            t.join();
+
+        CHECK(bad.load() == 0);
+        CHECK(loads.load() > 0);
+        CHECK(created.load() >= 1 + updates + updates / 4);   // failed exchanges built some more
+
+        // A weak handle is promoted on the way in; null stores clear the slot.
+        auto last = slot.load();
+        slot = last.make_weak(last);
+        CHECK(slot.load() == last);
+        last.reset();
+        slot.store(nullptr);
+        CHECK(!slot.load());
+    }
+
+    CHECK(destroyed.load() == created.load());
+    return 0;
+}
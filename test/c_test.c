@@ -1,4 +1,6 @@
 #include "collections/meta.h"
+#include "check.h"
+#include <stdint.h>
 #include <stdio.h>
 #include <stdlib.h>
 
@@ -33,8 +35,50 @@ int main() {
         printf("  n1->next = %p (should be NULL)\n", (void*)n1->next);
         printf("  n2->next = %p (should be NULL)\n", (void*)n2->next);
 
+        gc_free(n1);
+        gc_free(n2);
     }
 
+    gc_collect();
+
+    {
+        // calloc-style blocks start zeroed, recycled cells included
+        int* a = New_array(int, 1000);
+        CHECK(a != NULL);
+        for (int i = 0; i < 1000; ++i) CHECK(a[i] == 0);
+        gc_free(a);
+
+        CHECK(New_calloc(SIZE_MAX, 16) == NULL);
+        gc_free(NULL);
+    }
+
+    {
+        // Only the head stays a root; the rest live through the pointers
+        // found in each block
+        Node* head = NULL;
+        for (int i = 0; i < 1000; ++i) {
+            Node* n = New(Node);
+            CHECK(n != NULL);
+            n->x = i;
+            n->y = (float)i / 2;
+            n->next = head;
+            if (head) gc_free(head);
+            head = n;
+        }
+
+        gc_collect();
+        gc_collect();
+
+        int count = 0;
+        for (Node* n = head; n; n = n->next, ++count)
+            CHECK(n->x == 999 - count && n->y == (float)n->x / 2);
+        CHECK(count == 1000);
+
+        gc_free(head);
+    }
+
+    gc_collect();
+
     printf("Exiting\n");
 
     return 0;
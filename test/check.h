@@ -0,0 +1,22 @@
+#pragma once
+
+/**
+ * @file check.h
+ * @brief The assertion the tests under test/ share.
+ *
+ * Each test is a program of its own, since collector modes are process-wide
+ * and cannot be switched off again; it fails by exiting non-zero.  Plain C,
+ * so that the C API test shares it.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+
+/// Report @p cond with its location and fail the test unless it holds; active in every build type.
+#define CHECK(cond)                                                                  \
+    do {                                                                             \
+        if (!(cond)) {                                                               \
+            fprintf(stderr, "%s:%d: CHECK(%s) failed\n", __FILE__, __LINE__, #cond); \
+            exit(1);                                                                 \
+        }                                                                            \
+    } while (0)
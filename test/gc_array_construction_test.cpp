@@ -0,0 +1,211 @@
+// Array construction: value-initialized trivial arrays read as zero, recycled
+// cells included; gc_run_chunks() runs every chunk once, from one caller or
+// several; and large gc_parallel_construct arrays are built whole, or not
+// at all when a constructor throws, whose block no collection destroys
+// again.
+
+#include "collections/meta.h"
+#include "check.h"
+
+#include <atomic>
+#include <cstring>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+namespace {
+
+    struct leaf {
+        int value = 7;
+    };
+
+    struct cell {
+        GC::Ptr<leaf> item;
+        long          id;
+
+        cell() : item(GC::New<leaf>()), id(42) {}
+    };
+
+    std::atomic<long> made{ 0 };
+    std::atomic<long> gone{ 0 };
+    std::atomic<long> fail_at{ -1 };
+
+    struct fragile {
+        long id;
+
+        fragile() : id(made.fetch_add(1))
+        {
+            if (id == fail_at.load())
+                throw std::runtime_error("constructor failed");
+        }
+        ~fragile() { ++gone; }
+    };
+
+    struct pod {
+        double d[4];
+    };
+
+    /// Counts the calls of each of its chunks.
+    struct tally {
+        std::vector<std::atomic<int>> calls;
+        explicit tally(std::size_t n) : calls(n) {}
+
+        static void body(void* ctx, std::size_t chunk) noexcept { ++static_cast<tally*>(ctx)->calls[chunk]; }
+
+        [[nodiscard]] bool once() const
+        {
+            for (const std::atomic<int>& c : calls)
+                if (c.load() != 1)
+                    return false;
+            return true;
+        }
+    };
+
+} // anonymous namespace
+
+template <> struct GC::gc_pointer_map<cell> {
+    static constexpr auto members = std::make_tuple(&cell::item);
+};
+template <> struct GC::gc_parallel_construct<cell> : std::true_type {};
+
+template <> struct GC::gc_pointer_map<fragile> {
+    static constexpr auto members = std::tuple<>();
+};
+template <> struct GC::gc_parallel_construct<fragile> : std::true_type {};
+
+int main()
+{
+    // Recycled small cells are zeroed again for value-initialized arrays.
+    for (int r = 0; r < 100; ++r) {
+        GC::Ptr<unsigned char> dirty = GC::New<unsigned char[]>(1000);
+        std::memset(dirty.get(), 0xAB, 1000);
+    }
+    GC::gc_collect();
+    for (int r = 0; r < 100; ++r) {
+        GC::Ptr<unsigned char> clean = GC::New<unsigned char[]>(1000);
+        for (int i = 0; i < 1000; ++i)
+            CHECK(clean[i] == 0);
+    }
+    {
+        constexpr std::size_t n = std::size_t{ 1 } << 18;
+        GC::Ptr<pod> big = GC::New<pod[]>(n);   // a large block, zeroed by its fresh pages
+        for (std::size_t i = 0; i < n; ++i)
+            CHECK(big[i].d[0] == 0 && big[i].d[3] == 0);
+
+        GC::Ptr<pod> raw = GC::New_for_overwrite<pod[]>(1000);
+        raw[5].d[0] = 1;
+        CHECK(raw[5].d[0] == 1);
+        GC::Ptr<leaf> l = GC::New_for_overwrite<leaf>();   // a non-trivial T is still constructed
+        CHECK(l->value == 7);
+    }
+
+    // The helper pool runs each chunk once, call after call.
+    for (int r = 0; r < 100; ++r) {
+        tally t(8);
+        GC::gc_run_chunks(8, &tally::body, &t);
+        CHECK(t.once());
+    }
+    {
+        // Callers that find the pool busy run their chunks themselves.
+        std::vector<std::thread> callers;
+        std::atomic<int> bad{ 0 };
+        for (int k = 0; k < 3; ++k) {
+            callers.emplace_back([&] {
+                for (int r = 0; r < 100; ++r) {
+                    tally t(5);
+                    GC::gc_run_chunks(5, &tally::body, &t);
+                    if (!t.once())
+                        ++bad;
+                }
+            });
+        }
+        for (std::thread& c : callers)
+            c.join();
+        CHECK(bad.load() == 0);
+
+        // And so do nested calls.
+        tally outer(4);
+        GC::gc_run_chunks(4, [](void* ctx, std::size_t chunk) noexcept {
+            tally inner(3);
+            GC::gc_run_chunks(3, &tally::body, &inner);
+            if (inner.once())
+                tally::body(ctx, chunk);
+        }, &outer);
+        CHECK(outer.once());
+    }
+
+    // Mapped elements that allocate, built in chunks past gc_parallel_construct_min.
+    {
+        const std::size_t n = 4 * GC::gc_parallel_construct_min / sizeof(cell);
+        GC::Ptr<cell> cells = GC::New<cell[]>(n);
+        GC::gc_collect();
+        for (std::size_t i = 0; i < n; ++i)
+            CHECK(cells[i].id == 42 && cells[i].item && cells[i].item->value == 7);
+    }
+
+    // One constructor throws: every element built, in any chunk, is destroyed.
+    {
+        const std::size_t n = 4 * GC::gc_parallel_construct_min / sizeof(fragile);
+        fail_at.store(static_cast<long>(n / 2 + 3));
+        bool threw = false;
+        try {
+            GC::Ptr<fragile> f = GC::New<fragile[]>(n);
+        }
+        catch (const std::runtime_error&) {
+            threw = true;
+        }
+        CHECK(threw);
+        CHECK(gone.load() == made.load() - 1);
+        fail_at.store(-1);
+        GC::gc_collect();
+        CHECK(gone.load() == made.load() - 1);
+    }
+
+    // The same with few enough elements to be built in order, and for one object.
+    {
+        made.store(0);
+        gone.store(0);
+        fail_at.store(5);
+        bool threw = false;
+        try {
+            GC::Ptr<fragile> f = GC::New<fragile[]>(10);
+        }
+        catch (const std::runtime_error&) {
+            threw = true;
+        }
+        CHECK(threw && made.load() == 6 && gone.load() == 5);
+        GC::gc_collect();
+        CHECK(gone.load() == 5);
+
+        made.store(0);
+        gone.store(0);
+        fail_at.store(0);
+        threw = false;
+        try {
+            GC::Ptr<fragile> f = GC::New<fragile>();
+        }
+        catch (const std::runtime_error&) {
+            threw = true;
+        }
+        CHECK(threw && gone.load() == 0);
+        GC::gc_collect();
+        CHECK(gone.load() == 0);
+        fail_at.store(-1);
+    }
+
+    // Regions and heaps construct too.
+    {
+        GC::Region region;
+        GC::Ptr<cell> cells = GC::New<cell[]>(2 * GC::gc_parallel_construct_min / sizeof(cell));
+        CHECK(cells[0].id == 42 && cells[0].item->value == 7);
+    }
+    {
+        GC::Heap heap;
+        GC::heap_scope scope{ heap };
+        GC::Ptr<cell> cells = GC::New<cell[]>(2 * GC::gc_parallel_construct_min / sizeof(cell));
+        heap.collect();
+        CHECK(cells[100].item->value == 7);
+    }
+    GC::gc_collect();
+    return 0;
+}
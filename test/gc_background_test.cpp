@@ -0,0 +1,65 @@
+// Background collector: with the collector thread running, allocating
+// threads only wake it, yet their garbage is reclaimed and what they still
+// reach is kept.
+
+#include "collections/meta.h"
+#include "check.h"
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+namespace {
+
+    std::atomic<long> live{ 0 };
+
+    struct node {
+        GC::Ptr<node> next;
+        long          value;
+
+        explicit node(long v) : value(v) { ++live; }
+        ~node() { value = -1; --live; }
+    };
+
+} // anonymous namespace
+
+int main()
+{
+    GC::gc_set_heap({ .target_heap = 256 * 1024 });
+    GC::start_background_collector({ .period = std::chrono::milliseconds(5), .pressure_limit = 4 << 20 });
+    const std::uint64_t before = GC::gc_stats().collections;
+
+    std::atomic<int> bad{ 0 };
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 3; ++t) {
+        threads.emplace_back([&] {
+            GC::Ptr<node> head;
+            for (long i = 0; i < 1000; ++i) {
+                GC::Ptr<node> n = GC::New<node>(i);
+                n->next = head;
+                head = n;
+            }
+            for (int round = 0; round < 100000; ++round)
+                (void)GC::New<node>(round);
+            long expect = 999;
+            for (node* p = head.get(); p != nullptr; p = p->next.get(), --expect)
+                if (p->value != expect)
+                    ++bad;
+            if (expect != -1)
+                ++bad;
+        });
+    }
+    for (std::thread& t : threads)
+        t.join();
+
+    CHECK(bad.load() == 0);
+    CHECK(GC::gc_stats().collections > before);
+    CHECK(live.load() < 3 * 100000);
+
+    // Stopped again, collections run inline as before.
+    GC::stop_background_collector();
+    GC::gc_collect();
+    CHECK(live.load() == 0);
+    return 0;
+}
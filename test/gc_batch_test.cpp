@@ -0,0 +1,111 @@
+// GC::New_batch: n independent objects from one request, each collected on
+// its own, and none left behind or destroyed unconstructed when one of the
+// constructors throws.
+
+#include "collections/meta.h"
+#include "check.h"
+
+#include <stdexcept>
+
+namespace {
+
+    long constructed = 0;
+    long destroyed = 0;
+    long throw_at = -1;
+
+    long live() { return constructed - destroyed; }
+
+    struct node {
+        GC::Ptr<node> next;
+        GC::Ptr<node> owned;
+        long          value;
+
+        explicit node(long v) : owned(GC::New<node>(0L, 0L)), value(v)
+        {
+            if (constructed == throw_at)
+                throw std::runtime_error("constructor failed");
+            ++constructed;
+        }
+        node(long v, long) : value(v) { ++constructed; }
+        ~node() { ++destroyed; }
+    };
+
+    struct large {
+        char           payload[5000];
+        GC::Ptr<large> next;
+
+        large() { ++constructed; }
+        ~large() { ++destroyed; }
+    };
+
+    void run()
+    {
+        constexpr long n = 10000;
+        {
+            GC::New_batch<node> batch(n, 7L);
+            CHECK(batch.size() == static_cast<std::size_t>(n));
+            CHECK(live() == 2 * n);
+            for (long i = 0; i < n; ++i) {
+                CHECK(batch[i] && batch[i]->value == 7 && batch[i]->owned);
+                if (i > 0) {
+                    CHECK(batch[i].get() != batch[i - 1].get());
+                    batch[i]->next = batch[i - 1];
+                }
+            }
+
+            // Each object is collected on its own: a chain keeps what it reaches.
+            for (long i = 0; i < n / 2; ++i)
+                batch[i] = nullptr;
+            GC::gc_collect();
+            CHECK(live() == 2 * n);
+            for (long i = n / 2; i + 1 < n; ++i)
+                batch[i] = nullptr;
+            batch[n - 1]->next = batch[n - 1]->next->next;
+            GC::gc_collect();
+            CHECK(live() == 2 * n - 2);
+        }
+        GC::gc_collect();
+        CHECK(live() == 0);
+
+        {
+            GC::New_batch<large> big(100);
+            GC::gc_collect();
+            CHECK(live() == 100);
+        }
+        GC::gc_collect();
+        CHECK(live() == 0);
+
+        // The 500th constructor throws: its predecessors and their members
+        // become garbage, the cells after it are given back unconstructed.
+        throw_at = constructed + 2 * 499 + 1;
+        bool threw = false;
+        try {
+            GC::New_batch<node> failing(1000, 1L);
+        }
+        catch (const std::runtime_error&) {
+            threw = true;
+        }
+        CHECK(threw && constructed == throw_at);
+        throw_at = -1;
+        GC::gc_collect();
+        CHECK(live() == 0);
+
+        // The batch still works after the failed one.
+        {
+            GC::New_batch<node> again(1000, 3L);
+            CHECK(live() == 2000 && again[999]->value == 3);
+        }
+        GC::gc_collect();
+        CHECK(live() == 0);
+    }
+
+} // anonymous namespace
+
+int main()
+{
+    run();
+
+    GC::gc_set_generational({ .enabled = true });
+    run();
+    return 0;
+}
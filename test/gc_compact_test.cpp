@@ -0,0 +1,154 @@
+// gc_compact(): survivors of sparse chunks move, every heap pointer to them
+// is fixed up, linked or mapped, in objects and arrays, while rooted
+// objects, Local<> targets and gc_pinned types stay where they are.
+
+#include "collections/meta.h"
+#include "check.h"
+
+#include <string>
+#include <vector>
+
+namespace {
+
+    long live = 0;
+
+    struct node {
+        GC::Ptr<node> next;
+        GC::Ptr<node> other;
+        long          value;
+
+        explicit node(long v) : value(v) { ++live; }
+        ~node() { --live; }
+    };
+
+    struct mapped {
+        GC::Ptr<mapped> a;
+        long            pad[3];
+        GC::Ptr<node>   n;
+        long            value;
+
+        explicit mapped(long v) : value(v) { ++live; }
+        ~mapped() { --live; }
+    };
+
+    struct element {
+        GC::Ptr<node> p;
+        long          value = 3;
+    };
+
+    /// A short std::string may point into itself, which a memcpy would break.
+    struct fixed {
+        std::string    text;
+        GC::Ptr<fixed> next;
+
+        explicit fixed(long v) : text("key " + std::to_string(v)) { ++live; }
+        ~fixed() { --live; }
+    };
+
+} // anonymous namespace
+
+template <> struct GC::gc_pointer_map<mapped> {
+    static constexpr auto members = std::make_tuple(&mapped::a, &mapped::n);
+};
+
+template <> struct GC::gc_pinned<fixed> : std::true_type {};
+
+namespace {
+
+    void run()
+    {
+        constexpr long n = 100000;
+
+        // Every tenth node survives, so most chunks are left sparse.
+        GC::Ptr<node> head;
+        std::vector<GC::Ptr<node>> keep;
+        {
+            std::vector<GC::Ptr<node>> all;
+            for (long i = 0; i < n; ++i)
+                all.push_back(GC::New<node>(i));
+            for (long i = 0; i < n; i += 10)
+                keep.push_back(all[i]);
+            for (std::size_t i = 1; i < keep.size(); ++i) {
+                keep[i]->next = keep[i - 1];
+                keep[i]->other = keep[i / 2];
+            }
+            head = keep.back();
+        }
+        GC::Ptr<node> rooted = keep[123];
+        node* rooted_at = rooted.get();
+        keep.clear();
+        GC::Local<node> local = head->next->next;
+        node* local_at = &*local;
+
+        GC::Ptr<mapped> m = GC::New<mapped>(5);
+        m->a = GC::New<mapped>(6);
+        m->n = head->next;
+        {
+            std::vector<GC::Ptr<mapped>> junk;
+            for (int i = 0; i < 20000; ++i)
+                junk.push_back(GC::New<mapped>(i));
+        }
+
+        GC::Ptr<element> arr = GC::New<element[]>(100);
+        arr[7].p = head;
+
+        {
+            std::vector<GC::Ptr<fixed>> junk;
+            for (int i = 0; i < 5000; ++i)
+                junk.push_back(GC::New<fixed>(i));
+        }
+        GC::Ptr<fixed> f = GC::New<fixed>(1);
+        f->next = GC::New<fixed>(2);
+        fixed* pinned_at = f->next.get();
+
+        GC::gc_collect();
+        const long before = live;
+        const std::size_t moved = GC::gc_compact();
+        CHECK(moved > 0);
+        CHECK(live == before);
+
+        // Pinned in place.
+        CHECK(rooted.get() == rooted_at && rooted_at->value == 1230);
+        CHECK(&*local == local_at);
+        CHECK(f->next.get() == pinned_at);
+
+        // Moved objects are reached through fixed-up pointers.
+        long count = 0;
+        long expect = (n - 1) / 10 * 10;
+        for (node* p = head.get(); p != nullptr; p = p->next.get(), expect -= 10, ++count) {
+            CHECK(p->value == expect);
+            if (p->other)
+                CHECK(p->other->value % 10 == 0);
+        }
+        CHECK(count == n / 10);
+        CHECK(m->value == 5 && m->a->value == 6 && m->n.get() == head->next.get());
+        for (int i = 0; i < 100; ++i)
+            CHECK(arr[i].value == 3);
+        CHECK(arr[7].p.get() == head.get());
+        CHECK(f->text == "key 1" && f->next->text == "key 2");
+
+        // The heap is usable afterwards, and compacts again.
+        head->next->next = GC::New<node>(-1);
+        for (int i = 0; i < 1000; ++i)
+            (void)GC::New<node>(i);
+        GC::gc_collect();
+        CHECK(head->next->next->value == -1);
+        (void)GC::gc_compact(0.9);
+        CHECK(head->next->value == (n - 1) / 10 * 10 - 10);
+        CHECK(head->next->next->value == -1);
+    }
+
+} // anonymous namespace
+
+int main()
+{
+    run();
+    GC::gc_collect();
+    CHECK(live == 0);
+
+    GC::gc_set_generational({ .enabled = true });
+    run();
+    GC::gc_collect();
+    CHECK(live == 0);
+    return 0;
+}
@@ -0,0 +1,99 @@
+// Deferred finalization: dead objects wait on the queue until
+// run_finalizers() or a finalizer thread destroys them, while the types
+// marked gc_finalize_inline are still destroyed by the sweep.
+
+#include "collections/meta.h"
+#include "check.h"
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+namespace {
+
+    std::atomic<long> live{ 0 };
+    std::atomic<long> inline_live{ 0 };
+    std::atomic<long> off_thread{ 0 };
+    std::thread::id   main_thread;
+
+    struct resource {
+        GC::Ptr<resource> next;
+        std::vector<int>  buffer = std::vector<int>(8, 1);
+
+        resource() { ++live; }
+        ~resource()
+        {
+            --live;
+            if (std::this_thread::get_id() != main_thread)
+                ++off_thread;
+        }
+    };
+
+    struct urgent {
+        long value = 0;
+        urgent() { ++inline_live; }
+        ~urgent() { --inline_live; }
+    };
+
+    void garbage(int n)
+    {
+        GC::Ptr<resource> head;
+        for (int i = 0; i < n; ++i) {
+            GC::Ptr<resource> r = GC::New<resource>();
+            r->next = head;
+            head = r;
+            (void)GC::New<urgent>();
+        }
+    }
+
+} // anonymous namespace
+
+template <> struct GC::gc_finalize_inline<urgent> : std::true_type {};
+
+int main()
+{
+    main_thread = std::this_thread::get_id();
+
+    // Queued only: gc_collect() leaves the destructors to run_finalizers().
+    GC::gc_set_finalizers({ .deferred = true, .threads = 0 });
+    GC::Ptr<resource> kept = GC::New<resource>();
+    garbage(10000);
+    GC::gc_collect();
+    CHECK(inline_live.load() == 0);
+    CHECK(live.load() == 10000 + 1);
+
+    // A small budget still runs one batch.
+    const std::size_t first = GC::run_finalizers(std::chrono::microseconds(1));
+    CHECK(first > 0);
+    const std::size_t rest = GC::run_finalizers();
+    CHECK(first + rest == 10000);
+    CHECK(live.load() == 1);
+    CHECK(GC::run_finalizers() == 0);
+    CHECK(kept->buffer.size() == 8);
+
+    // Finalizer threads drain the queue by themselves.
+    GC::gc_set_finalizers({ .deferred = true, .threads = 2 });
+    garbage(10000);
+    GC::gc_collect();
+    CHECK(inline_live.load() == 0);
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(30);
+    while (live.load() != 1 && std::chrono::steady_clock::now() < deadline)
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    CHECK(live.load() == 1);
+    CHECK(off_thread.load() > 0);
+
+    // Switched off: the sweep destroys again, on the collecting thread.
+    GC::gc_set_finalizers({ .deferred = false });
+    off_thread.store(0);
+    garbage(1000);
+    GC::gc_collect();
+    CHECK(live.load() == 1);
+    CHECK(off_thread.load() == 0);
+
+    kept = nullptr;
+    GC::gc_collect();
+    (void)GC::run_finalizers();
+    CHECK(live.load() == 0);
+    return 0;
+}
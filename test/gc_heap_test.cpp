@@ -0,0 +1,95 @@
+// GC::Heap: objects allocated inside a heap_scope are collected with their
+// own heap, from several threads, independently of the default heap, and
+// ~Heap destroys whatever is left in it.
+
+#include "collections/meta.h"
+#include "check.h"
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+namespace {
+
+    std::atomic<long> live{ 0 };
+
+    struct node {
+        GC::Ptr<node> next;
+        GC::Ptr<node> other;
+        long          value = 0;
+
+        node() { ++live; }
+        ~node() { --live; }
+    };
+
+    long length(const GC::Ptr<node>& head)
+    {
+        long n = 0;
+        for (node* p = head.get(); p != nullptr; p = p->next.get())
+            ++n;
+        return n;
+    }
+
+} // anonymous namespace
+
+int main()
+{
+    GC::Ptr<node> outside = GC::New<node>();
+
+    {
+        GC::Heap heap({ .target_heap = 64 * 1024 });
+        GC::Ptr<node> head;
+        {
+            GC::heap_scope scope{ heap };
+            for (int i = 0; i < 20000; ++i) {
+                GC::Ptr<node> n = GC::New<node>();
+                n->value = i;
+                n->next = head;
+                head = n;
+            }
+
+            // Garbage cycles from several threads, collected by the heap's own trigger.
+            std::vector<std::thread> threads;
+            std::atomic<int> bad{ 0 };
+            for (int t = 0; t < 3; ++t) {
+                threads.emplace_back([&] {
+                    GC::heap_scope inner{ heap };
+                    for (int k = 0; k < 20000; ++k) {
+                        GC::Local<node> x = GC::New<node>();
+                        GC::Local<node> y = GC::New<node>();
+                        x->next = y;
+                        y->next = x;
+                    }
+                    if (length(head) != 20000)
+                        ++bad;
+                });
+            }
+            for (std::thread& t : threads)
+                t.join();
+            CHECK(bad.load() == 0);
+
+            heap.collect();
+            CHECK(live.load() == 20000 + 1);
+            CHECK(length(head) == 20000);
+
+            // Pointing into the default heap is allowed; `outside` stays rooted regardless.
+            head->other = outside;
+        }
+        // Collecting the default heap leaves this one alone.
+        GC::gc_collect();
+        CHECK(live.load() == 20000 + 1);
+        CHECK(length(head) == 20000);
+
+        head->other = nullptr;
+        head = nullptr;
+    }
+
+    // The heap's 20000 objects went with it, uncollected; the default heap's did not.
+    CHECK(live.load() == 1);
+    CHECK(outside->value == 0);
+
+    outside = nullptr;
+    GC::gc_collect();
+    CHECK(live.load() == 0);
+    return 0;
+}
@@ -0,0 +1,92 @@
+// Lazy sweeping: automatic collections leave their garbage to be swept by
+// later allocations, which reclaim it without touching the survivors, while
+// gc_collect() sweeps everything before it returns.
+
+#include "collections/meta.h"
+#include "check.h"
+
+#include <algorithm>
+#include <vector>
+
+namespace {
+
+    std::vector<bool> destroyed;
+    long              live = 0;
+    long              peak = 0;
+
+    /// One of three size classes, each with a destructor the sweep has to run.
+    template <std::size_t Pad>
+    struct blob {
+        std::size_t id;
+        char        pad[Pad];
+
+        blob() : id(destroyed.size())
+        {
+            destroyed.push_back(false);
+            peak = std::max(peak, ++live);
+        }
+        ~blob() { destroyed[id] = true; --live; }
+    };
+
+    struct roots {
+        std::vector<GC::Ptr<blob<8>>>    small;
+        std::vector<GC::Ptr<blob<200>>>  medium;
+        std::vector<GC::Ptr<blob<3000>>> large;
+    };
+
+    bool intact(const roots& r)
+    {
+        for (const auto& p : r.small)  if (destroyed[p->id]) return false;
+        for (const auto& p : r.medium) if (destroyed[p->id]) return false;
+        for (const auto& p : r.large)  if (destroyed[p->id]) return false;
+        return true;
+    }
+
+} // anonymous namespace
+
+int main()
+{
+    constexpr long allocations = 300000;
+    destroyed.reserve(allocations * 2);
+    GC::gc_set_heap({ .target_heap = 256 * 1024, .growth_factor = 2.0 });
+
+    roots r;
+    for (int i = 0; i < 300; ++i) {
+        r.small.push_back(GC::New<blob<8>>());
+        r.medium.push_back(GC::New<blob<200>>());
+        r.large.push_back(GC::New<blob<3000>>());
+    }
+
+    for (long i = 0; i < allocations; ++i) {
+        // Mostly garbage; now and then a root is replaced, so survivors and
+        // dead objects share chunks.
+        const std::size_t k = static_cast<std::size_t>(i * 7919) % 300;
+        switch (i % 16) {
+        case 0:  r.small[k] = GC::New<blob<8>>();     break;
+        case 1:  r.medium[k] = GC::New<blob<200>>();  break;
+        case 2:  r.large[k] = GC::New<blob<3000>>();  break;
+        case 3:  (void)GC::New<blob<3000>>();         break;
+        case 4:
+        case 5:  (void)GC::New<blob<200>>();          break;
+        default: (void)GC::New<blob<8>>();            break;
+        }
+        if (i % 10000 == 0)
+            CHECK(intact(r));
+    }
+
+    // The automatic collections reclaimed the garbage as it was allocated.
+    const GC::heap_stats stats = GC::gc_stats();
+    CHECK(stats.collections > 0);
+    CHECK(stats.freed_objects > 0);
+    CHECK(peak < allocations / 4);
+    CHECK(intact(r));
+
+    GC::gc_collect();
+    CHECK(intact(r));
+    CHECK(live == 900);
+
+    r = {};
+    GC::gc_collect();
+    CHECK(live == 0);
+    return 0;
+}
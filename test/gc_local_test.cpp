@@ -0,0 +1,103 @@
+// Local<T>: scoped roots in the per-thread shadow stack keep their objects
+// alive through collections, copied, moved and reassigned, past the point
+// where the slots run out, on several threads and with an incremental
+// cycle under way.
+
+#include "collections/meta.h"
+#include "check.h"
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include <vector>
+
+namespace {
+
+    std::atomic<long> live{ 0 };
+
+    struct node {
+        GC::Ptr<node> next;
+        long          value;
+
+        explicit node(long v) : value(v) { ++live; }
+        ~node() { --live; }
+    };
+
+    /// Holds @p depth Locals at once on the way down, then collects.
+    long nest(int depth)
+    {
+        GC::Local<node> here = GC::New<node>(depth);
+        if (depth == 0) {
+            GC::gc_collect();
+            return live.load();
+        }
+        const long seen = nest(depth - 1);
+        CHECK(here->value == depth);
+        return seen;
+    }
+
+} // anonymous namespace
+
+int main()
+{
+    {
+        GC::Local<node> a = GC::New<node>(1);
+        GC::Local<node> b = a;                // copy
+        GC::Local<node> c = std::move(b);     // takes over the slot
+        GC::Local<node> d;
+        d = GC::New<node>(2);
+        d->next = GC::New<node>(3);           // reached through d alone
+        GC::gc_collect();
+        CHECK(live.load() == 3);
+        CHECK(a == c && !b && d->next->value == 3);
+
+        a = nullptr;
+        GC::gc_collect();
+        CHECK(live.load() == 3);              // c still holds it
+        c.reset();
+        GC::gc_collect();
+        CHECK(live.load() == 2);
+
+        GC::Ptr<node> counted = d;            // a counted root to the same object
+        d = nullptr;
+        GC::gc_collect();
+        CHECK(live.load() == 2 && counted->next->value == 3);
+    }
+    GC::gc_collect();
+    CHECK(live.load() == 0);
+
+    // More than the slots hold: the rest fall back to counting.
+    CHECK(nest(5000) == 5001);
+    GC::gc_collect();
+    CHECK(live.load() == 0);
+
+    // Threads of their own, with automatic incremental slices in between.
+    GC::gc_set_incremental({ .enabled = true, .pause_budget = std::chrono::microseconds(20), .step_interval = 4096 });
+    std::atomic<int> bad{ 0 };
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 3; ++t) {
+        threads.emplace_back([&] {
+            for (int round = 0; round < 2000; ++round) {
+                GC::Local<node> head = GC::New<node>(0);
+                GC::Local<node> tail = head;
+                for (int i = 1; i < 20; ++i) {
+                    GC::Local<node> n = GC::New<node>(i);
+                    tail->next = n;
+                    tail = n;
+                }
+                long expect = 0;
+                for (GC::Local<node> p = head; p; p = p->next, ++expect)
+                    if (p->value != expect)
+                        ++bad;
+                if (expect != 20)
+                    ++bad;
+            }
+        });
+    }
+    for (std::thread& t : threads)
+        t.join();
+    CHECK(bad.load() == 0);
+    GC::gc_collect();
+    CHECK(live.load() == 0);
+    return 0;
+}
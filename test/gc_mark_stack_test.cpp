@@ -0,0 +1,94 @@
+// Mark-stack overflow: built with GC_MARK_STACK_LIMIT at 1024 entries, an
+// object with far more children than that overflows the stack, and the
+// rescan still marks all of them in serial, parallel, generational and
+// per-heap traces.
+
+#include "collections/meta.h"
+#include "check.h"
+
+namespace {
+
+    long live = 0;
+
+    struct node {
+        GC::Ptr<node> next;
+        long          value;
+
+        explicit node(long v) : value(v) { ++live; }
+        ~node() { --live; }
+    };
+
+    struct slot {
+        GC::Ptr<node> p;
+    };
+
+    constexpr long width = 20000;
+
+    GC::Ptr<slot> build()
+    {
+        GC::Ptr<slot> wide = GC::New<slot[]>(width);
+        for (long i = 0; i < width; ++i) {
+            wide[i].p = GC::New<node>(i);
+            wide[i].p->next = GC::New<node>(-i);
+        }
+        return wide;
+    }
+
+    bool intact(const GC::Ptr<slot>& wide)
+    {
+        for (long i = 0; i < width; ++i)
+            if (wide[i].p->value != i || wide[i].p->next->value != -i)
+                return false;
+        return true;
+    }
+
+    void collect_twice(const GC::Ptr<slot>& wide)
+    {
+        for (int k = 0; k < 2; ++k) {
+            GC::gc_collect();
+            CHECK(live == 2 * width);
+            CHECK(intact(wide));
+        }
+    }
+
+} // anonymous namespace
+
+int main()
+{
+    GC::Ptr<slot> wide = build();
+    collect_twice(wide);
+
+    GC::gc_set_mark_workers(4);
+    collect_twice(wide);
+    GC::gc_set_mark_workers(1);
+
+    GC::gc_set_generational({ .enabled = true, .nursery_size = 64 * 1024 });
+    wide = nullptr;
+    GC::gc_collect();
+    CHECK(live == 0);
+    wide = build();   // young, so the minor collections trace it too
+    for (int k = 0; k < 3; ++k) {
+        GC::gc_collect_minor();
+        CHECK(intact(wide));
+    }
+    collect_twice(wide);
+    GC::gc_set_generational({ .enabled = false });
+
+    {
+        GC::Heap heap;
+        GC::Ptr<slot> other;
+        {
+            GC::heap_scope scope{ heap };
+            other = build();
+        }
+        heap.collect();
+        CHECK(live == 4 * width);
+        CHECK(intact(other));
+        other = nullptr;
+    }
+
+    wide = nullptr;
+    GC::gc_collect();
+    CHECK(live == 0);
+    return 0;
+}
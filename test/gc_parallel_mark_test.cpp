@@ -0,0 +1,90 @@
+// Parallel marking: with several mark workers, a wide array, a long list
+// and a binary tree are all marked completely, with mapped and linked
+// types mixed, and the worker count can change between collections.
+
+#include "collections/meta.h"
+#include "check.h"
+
+#include <atomic>
+
+namespace {
+
+    std::atomic<long> live{ 0 };
+
+    struct node {
+        GC::Ptr<node> next;
+        GC::Ptr<node> left;
+        GC::Ptr<node> right;
+        long          value;
+
+        explicit node(long v) : value(v) { ++live; }
+        ~node() { --live; }
+    };
+
+    struct mapped {
+        GC::Ptr<node>   n;
+        GC::Ptr<mapped> m;
+    };
+
+    GC::Ptr<node> tree(int depth)
+    {
+        GC::Ptr<node> t = GC::New<node>(depth);
+        if (depth > 0) {
+            t->left = tree(depth - 1);
+            t->right = tree(depth - 1);
+        }
+        return t;
+    }
+
+    long count(const node* t)
+    {
+        return t == nullptr ? 0 : 1 + count(t->left.get()) + count(t->right.get());
+    }
+
+} // anonymous namespace
+
+template <> struct GC::gc_pointer_map<mapped> {
+    static constexpr auto members = std::make_tuple(&mapped::n, &mapped::m);
+};
+
+int main()
+{
+    constexpr long width = 50000;
+    constexpr long length = 50000;
+    constexpr int  depth = 15;
+
+    GC::Ptr<mapped> wide = GC::New<mapped[]>(width);
+    for (long i = 0; i < width; ++i) {
+        wide[i].n = GC::New<node>(i);
+        wide[i].m = GC::New<mapped>();
+        wide[i].m->n = GC::New<node>(-i);
+    }
+    GC::Ptr<node> list = GC::New<node>(0);
+    for (long i = 1; i < length; ++i) {
+        GC::Ptr<node> n = GC::New<node>(i);
+        n->next = list;
+        list = n;
+    }
+    GC::Ptr<node> root = tree(depth);
+    const long expected = 2 * width + length + (2L << depth) - 1;
+
+    for (unsigned workers : { 4u, 2u, 0u, 1u }) {
+        GC::gc_set_mark_workers(workers);
+        for (int k = 0; k < 2; ++k) {
+            (void)GC::New<node>(-1);   // garbage, so there is something to free
+            GC::gc_collect();
+            CHECK(live.load() == expected);
+        }
+        for (long i = 0; i < width; ++i)
+            CHECK(wide[i].n->value == i && wide[i].m->n->value == -i);
+        CHECK(count(root.get()) == (2L << depth) - 1);
+    }
+
+    wide = nullptr;
+    list = nullptr;
+    root = nullptr;
+    GC::gc_set_mark_workers(4);
+    GC::gc_collect();
+    CHECK(live.load() == 0);
+    return 0;
+}
@@ -0,0 +1,127 @@
+// Pointer maps: a type that lists its Ptr<> members is traced through those
+// slots alone, in single objects and arrays, mixed with linked types, and
+// through the generational write barrier.
+
+#include "collections/meta.h"
+#include "check.h"
+
+#include <string>
+#include <vector>
+
+namespace {
+
+    std::vector<bool> destroyed;
+    long              live = 0;
+
+    struct tracked {
+        std::size_t id;
+        tracked() : id(destroyed.size()) { destroyed.push_back(false); ++live; }
+        tracked(const tracked&) = delete;
+        ~tracked() { destroyed[id] = true; --live; }
+    };
+
+    struct plain;
+
+    /// Mapped, with non-pointer members between the slots.
+    struct mapped : tracked {
+        GC::Ptr<mapped> next;
+        std::string     text;
+        GC::Ptr<plain>  other;
+        int             value;
+
+        explicit mapped(int v);
+    };
+
+    /// Linked the usual way, pointing back into mapped objects.
+    struct plain : tracked {
+        GC::Ptr<mapped> back;
+    };
+
+    mapped::mapped(int v) : text(std::to_string(v) + " spills past the small string buffer"), value(v)
+    {
+        // Allocates while `other` is still a null slot, which marking may meet.
+        if (v % 97 == 0)
+            other = GC::New<plain>();
+    }
+
+    struct leaf {
+        GC::Ptr<mapped> node;
+        GC::Ptr<leaf>   sibling;
+    };
+
+} // anonymous namespace
+
+template <> struct GC::gc_pointer_map<mapped> {
+    static constexpr auto members = std::make_tuple(&mapped::next, &mapped::other);
+};
+
+template <> struct GC::gc_pointer_map<leaf> {
+    static constexpr auto members = std::make_tuple(&leaf::node, &leaf::sibling);
+};
+
+namespace {
+
+    /// Checks everything reachable from the list and the array; returns the list length.
+    long verify(const GC::Ptr<mapped>& head, const GC::Ptr<leaf>& leaves, std::size_t count)
+    {
+        long n = 0;
+        for (mapped* m = head.get(); m != nullptr; m = m->next.get(), ++n) {
+            CHECK(!destroyed[m->id]);
+            CHECK(m->text.starts_with(std::to_string(m->value) + " "));
+            if (m->other) {
+                CHECK(!destroyed[m->other->id]);
+                if (m->other->back)
+                    CHECK(!destroyed[m->other->back->id]);
+            }
+        }
+        for (std::size_t i = 0; i < count; ++i) {
+            for (leaf* l = &leaves[i]; l != nullptr; l = l->sibling.get())
+                if (l->node)
+                    CHECK(!destroyed[l->node->id] && l->node->value >= 0);
+        }
+        return n;
+    }
+
+    void run()
+    {
+        constexpr std::size_t slots = 16;
+        GC::Ptr<mapped> head;
+        GC::Ptr<leaf> leaves = GC::New<leaf[]>(slots);
+
+        for (int i = 0; i < 50000; ++i) {
+            GC::Ptr<mapped> m = GC::New<mapped>(i);
+            if (i % 3 == 0) {
+                m->next = head;
+                head = m;
+            }
+            if (m->other && i % 2 == 0)
+                m->other->back = GC::New<mapped>(-1);    // reachable through a linked object only
+            if (i % 500 == 0) {
+                leaves[i / 500 % slots].node = m;        // kept through the array alone
+                leaves[i / 500 % slots].sibling = GC::New<leaf>();
+                leaves[i / 500 % slots].sibling->node = GC::New<mapped>(i);
+            }
+            if (i % 10000 == 0)
+                GC::gc_collect();
+        }
+
+        GC::gc_collect();
+        CHECK(verify(head, leaves, slots) == 50000 / 3 + 1);
+
+        head = nullptr;
+        leaves = nullptr;
+        GC::gc_collect();
+        CHECK(live == 0);
+    }
+
+} // anonymous namespace
+
+int main()
+{
+    destroyed.reserve(1 << 20);
+    run();
+
+    GC::gc_set_generational({ .enabled = true, .nursery_size = 64 * 1024 });
+    run();
+    return 0;
+}
@@ -0,0 +1,76 @@
+// GC::Region: objects allocated in a region are never collected, and all
+// go when it ends, arrays and nested regions included, leaving the default
+// heap as it was.
+
+#include "collections/meta.h"
+#include "check.h"
+
+namespace {
+
+    long live = 0;
+
+    struct node {
+        GC::Ptr<node> next;
+        long          value = 0;
+
+        node() { ++live; }
+        ~node() { --live; }
+    };
+
+    struct trivial {
+        long value[4];
+    };
+
+} // anonymous namespace
+
+int main()
+{
+    GC::Ptr<node> keep = GC::New<node>();
+    keep->value = 42;
+
+    {
+        GC::Region region(true);   // also checks that nothing escapes
+        GC::Ptr<node> head;
+        for (int i = 0; i < 100000; ++i) {
+            GC::Ptr<node> n = GC::New<node>();
+            n->value = i;
+            n->next = head;
+            head = n;
+            (void)GC::New<node>();   // unreachable, yet kept until the region ends
+        }
+
+        // A collection of the default heap does not trace or free region objects.
+        GC::gc_collect();
+        CHECK(live == 1 + 2 * 100000);
+
+        {
+            GC::Region inner;
+            GC::Ptr<node> arr = GC::New<node[]>(1000);
+            GC::Ptr<trivial> raw = GC::New<trivial[]>(1000);
+            raw[999].value[3] = 7;
+            GC::New_batch<node> batch(100);
+            CHECK(live == 1 + 2 * 100000 + 1100);
+        }
+        CHECK(live == 1 + 2 * 100000);
+
+        long expect = 99999;
+        for (node* p = head.get(); p != nullptr; p = p->next.get(), --expect)
+            CHECK(p->value == expect);
+        CHECK(expect == -1);
+        head = nullptr;
+    }
+
+    CHECK(live == 1);
+    CHECK(keep->value == 42);
+
+    // The default heap still allocates and collects as before.
+    for (int i = 0; i < 1000; ++i)
+        (void)GC::New<node>();
+    GC::gc_collect();
+    CHECK(live == 1);
+
+    keep = nullptr;
+    GC::gc_collect();
+    CHECK(live == 0);
+    return 0;
+}
@@ -0,0 +1,93 @@
+// Collector statistics: allocation counters summed over threads, exited
+// ones included, per-collection records, with large blocks counted at their
+// real size, the pause histogram, and the callbacks run around every
+// collection.
+
+#include "collections/meta.h"
+#include "check.h"
+
+#include <numeric>
+#include <thread>
+
+namespace {
+
+    struct node {
+        GC::Ptr<node> next;
+        long          value = 0;
+    };
+
+} // anonymous namespace
+
+int main()
+{
+    int started = 0;
+    int ended = 0;
+    GC::collection_record last{};
+    GC::gc_set_callbacks({
+        .on_start = [&] { ++started; },
+        .on_end = [&](const GC::collection_record& r) {
+            ++ended;
+            last = r;
+            (void)GC::New<node>();   // hooks may allocate
+        },
+    });
+
+    const GC::heap_stats before = GC::gc_stats();
+
+    GC::Ptr<node> keep = GC::New<node>();
+    for (int i = 0; i < 1000; ++i)
+        (void)GC::New<node>();
+    std::thread([] {
+        for (int i = 0; i < 1000; ++i)
+            (void)GC::New<node>();
+    }).join();
+
+    const GC::heap_stats mid = GC::gc_stats();
+    CHECK(mid.allocated_objects - before.allocated_objects == 2001);
+    CHECK(mid.allocated_bytes - before.allocated_bytes >= 2001 * sizeof(node));
+
+    GC::gc_collect();
+    CHECK(started == 1 && ended == 1);
+    CHECK(last.kind == GC::collection_kind::full && last.completed);
+    CHECK(last.marked_objects >= 1);
+    CHECK(last.freed_objects >= 2000);
+
+    GC::gc_collect();
+    const GC::heap_stats after = GC::gc_stats();
+    CHECK(started == 2 && ended == 2);
+    CHECK(after.collections - before.collections == 2);
+    CHECK(after.freed_objects - before.freed_objects >= 2000);
+    CHECK(after.max_pause > std::chrono::nanoseconds(0));
+    CHECK(after.total_pause >= after.max_pause);
+    CHECK(std::accumulate(after.pause_histogram.begin(), after.pause_histogram.end(), std::uint64_t{ 0 }) == after.collections);
+    CHECK(!after.history.empty() && after.history.size() <= GC::gc_history_length);
+    CHECK(after.history.back().start >= after.history.front().start);
+
+    // A large block counts as the bytes asked for, not the chunks mapped for it.
+    {
+        constexpr std::size_t big = 100 * 1024;
+        GC::Ptr<unsigned char> block = GC::New<unsigned char[]>(big);
+        GC::gc_collect();
+        const std::size_t marked = GC::gc_stats().history.back().marked_bytes;
+        CHECK(marked >= big && marked < big + 4096);
+
+        // Likewise when a minor collection marks it young, and when it is freed.
+        GC::gc_set_generational({ .enabled = true });
+        GC::Ptr<unsigned char> young = GC::New<unsigned char[]>(big);
+        GC::gc_collect_minor();
+        const std::size_t marked_young = GC::gc_stats().history.back().marked_bytes;
+        CHECK(marked_young >= big && marked_young < big + 4096);
+        young = nullptr;
+        block = nullptr;
+        GC::gc_collect();
+        const std::size_t freed = GC::gc_stats().history.back().freed_bytes;
+        CHECK(freed >= 2 * big && freed < 2 * big + 4096);
+        GC::gc_set_generational({ .enabled = false });
+    }
+
+    // Removed hooks are not called again.
+    GC::gc_set_callbacks({});
+    GC::gc_collect();
+    CHECK(started == 5 && ended == 5);
+    return 0;
+}
@@ -0,0 +1,79 @@
+// Fused VMakeShared<T[]> and VMakeSharedForOverwrite: elements are value-
+// or default-initialized in the block's own allocation, a zero-length array
+// constructs nothing, and a throwing constructor leaves nothing behind.
+
+#include "collections/meta.h"
+#include "check.h"
+
+#include <stdexcept>
+
+namespace {
+
+    long made = 0;
+    long gone = 0;
+    long fail_at = -1;
+
+    struct counted {
+        long id;
+
+        counted() : id(made)
+        {
+            if (made == fail_at)
+                throw std::runtime_error("constructor failed");
+            ++made;
+        }
+        ~counted() { ++gone; }
+    };
+
+    struct pod {
+        int v = 3;
+    };
+
+} // anonymous namespace
+
+int main()
+{
+    {
+        auto zeros = ptr::VMakeShared<int[]>(1 << 20);
+        long sum = 0;
+        for (int i = 0; i < (1 << 20); ++i)
+            sum += zeros[i];
+        CHECK(sum == 0);
+
+        auto raw = ptr::VMakeSharedForOverwrite<int[]>(100);
+        raw[5] = 1;
+        CHECK(raw[5] == 1);
+        auto one = ptr::VMakeSharedForOverwrite<pod>();
+        CHECK(one->v == 3);   // a non-trivial T is still constructed
+        auto some = ptr::VMakeSharedForOverwrite<pod[]>(10);
+        CHECK(some[9].v == 3);
+    }
+
+    // A zero-length array is a live, fused handle with no element in it.
+    {
+        auto empty = ptr::VMakeShared<counted[]>(0);
+        auto empty_raw = ptr::VMakeSharedForOverwrite<counted[]>(0);
+        CHECK(empty.get() != nullptr && empty_raw.get() != nullptr);
+        CHECK(made == 0);
+    }
+    CHECK(gone == 0);
+
+    {
+        auto many = ptr::VMakeShared<counted[]>(1000);
+        CHECK(made == 1000 && many[999].id == 999);
+    }
+    CHECK(gone == 1000);
+
+    // The 500th constructor throws: the 499 before it are destroyed.
+    made = gone = 0;
+    fail_at = 499;
+    bool threw = false;
+    try {
+        auto failing = ptr::VMakeShared<counted[]>(1000);
+    }
+    catch (const std::runtime_error&) {
+        threw = true;
+    }
+    CHECK(threw && made == 499 && gone == 499);
+    return 0;
+}
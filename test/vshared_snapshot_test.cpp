@@ -0,0 +1,75 @@
+// VSharedPtr::snapshot(): lock-free copies of a trivially copyable object
+// never see a write half done, however often a writer goes through
+// operator->; read_access() readers see whole writes too.
+
+#include "collections/meta.h"
+#include "check.h"
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+namespace {
+
+    struct config {
+        long a, b, c, d;
+
+        void bump() { ++a; ++b; ++c; ++d; }
+        [[nodiscard]] bool whole() const { return a == b && b == c && c == d; }
+    };
+
+} // anonymous namespace
+
+int main()
+{
+    constexpr long reads_wanted = 10'000'000;
+    constexpr int  readers = 3;
+
+    auto cfg = ptr::VMakeShared<config>(config{ 0, 0, 0, 0 });
+    std::atomic<bool> written{ false };
+    std::atomic<long> reads{ 0 };
+    std::atomic<long> torn{ 0 };
+    std::atomic<long> last{ 0 };
+
+    // Keeps writing until the readers have had their reads.
+    std::thread writer([&] {
+        long n = 0;
+        while (reads.load(std::memory_order_relaxed) < reads_wanted) {
+            cfg->bump();
+            ++n;
+        }
+        last.store(n);
+        written.store(true);
+    });
+
+    std::vector<std::thread> threads;
+    for (int r = 0; r < readers; ++r) {
+        threads.emplace_back([&, r] {
+            long previous = 0;
+            while (!written.load()) {
+                constexpr long batch = 1000;
+                for (long i = 0; i < batch; ++i) {
+                    config c;
+                    if (r == 0 && i % 16 == 0)
+                        c = *cfg.read_access();
+                    else
+                        c = cfg.snapshot();
+                    if (!c.whole() || c.a < previous)
+                        torn.fetch_add(1, std::memory_order_relaxed);
+                    previous = c.a;
+                }
+                reads.fetch_add(batch, std::memory_order_relaxed);
+            }
+        });
+    }
+
+    writer.join();
+    for (std::thread& t : threads)
+        t.join();
+
+    CHECK(reads.load() >= reads_wanted);
+    CHECK(torn.load() == 0);
+    const config final_value = cfg.snapshot();
+    CHECK(final_value.whole() && final_value.a == last.load());
+    return 0;
+}